@@ -0,0 +1,165 @@
+#include "AsyncLogWriter.h"
+
+using namespace std;
+
+const chrono::milliseconds IO_THREAD_IDLE_WAIT(50);
+
+
+AsyncLogWriter::AsyncLogWriter(
+	function<void(PendingLogLine&)> write_line,
+	function<void()> on_idle,
+	size_t queue_capacity,
+	LogQueueFullPolicy policy) :
+	writeLine(write_line), onIdle(on_idle), fullPolicy(policy), queue(queue_capacity) {
+	ioThread = thread(&AsyncLogWriter::IOThreadLoop, this);
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+	stopRequested = true;
+	WakeIOThread();
+	if (ioThread.joinable())
+		ioThread.join();
+}
+
+void AsyncLogWriter::Enqueue(PendingLogLine&& pending) {
+	enqueuedLines++;
+
+	// Once lines have overflowed, keep overflowing until the I/O thread catches up so order is kept
+	if (overflowPending) {
+		lock_guard<mutex> lock(overflowMutex);
+		if (overflowPending) {
+			overflow.push_back(move(pending));
+			overflowLines++;
+			WakeIOThread();
+			return;
+		}
+	}
+
+	unsigned long long finished = finishedLines;
+	while (!queue.TryPush(move(pending))) {
+		if (fullPolicy == LogQueueFullPolicy::DROP_OLDEST) {
+			PendingLogLine discarded;
+			if (queue.TryPop(discarded)) {
+				droppedLines++;
+				FinishLines(1);
+			}
+		}
+		else if (fullPolicy == LogQueueFullPolicy::GROW) {
+			lock_guard<mutex> lock(overflowMutex);
+			overflow.push_back(move(pending));
+			overflowPending = true;
+			overflowLines++;
+			break;
+		}
+		else {
+			WaitForProgress(finished);
+			finished = finishedLines;
+		}
+	}
+
+	RecordQueueDepth();
+	WakeIOThread();
+}
+
+void AsyncLogWriter::WaitUntilDrained() {
+	unsigned long long enqueued = enqueuedLines;
+	unsigned long long finished = finishedLines;
+	while (finished < enqueued) {
+		WaitForProgress(finished);
+		finished = finishedLines;
+	}
+}
+
+size_t AsyncLogWriter::GetQueueDepth() const {
+	return queue.ApproximateSize();
+}
+
+size_t AsyncLogWriter::GetPeakQueueDepth() const {
+	return peakQueueDepth;
+}
+
+unsigned long long AsyncLogWriter::GetDroppedLineCount() const {
+	return droppedLines;
+}
+
+unsigned long long AsyncLogWriter::GetOverflowLineCount() const {
+	return overflowLines;
+}
+
+void AsyncLogWriter::IOThreadLoop() {
+	for (;;) {
+		if (DrainOnce())
+			continue;
+
+		if (onIdle)
+			onIdle();
+
+		if (stopRequested and finishedLines >= enqueuedLines)
+			return;
+
+		unique_lock<mutex> lock(wakeMutex);
+		ioThreadSleeping = true;
+		wakeCondition.wait_for(lock, IO_THREAD_IDLE_WAIT);
+		ioThreadSleeping = false;
+	}
+}
+
+// Writes everything currently queued, then everything that overflowed.
+// Returns true if any line was written.
+bool AsyncLogWriter::DrainOnce() {
+	bool wroteAny = false;
+
+	PendingLogLine pending;
+	while (queue.TryPop(pending)) {
+		writeLine(pending);
+		FinishLines(1);
+		wroteAny = true;
+	}
+
+	if (overflowPending) {
+		deque<PendingLogLine> overflowed;
+		{
+			lock_guard<mutex> lock(overflowMutex);
+			overflowed.swap(overflow);
+			overflowPending = false;
+		}
+		for (auto& overflowedLine : overflowed) {
+			writeLine(overflowedLine);
+			FinishLines(1);
+		}
+		wroteAny = wroteAny or !overflowed.empty();
+	}
+
+	return wroteAny;
+}
+
+void AsyncLogWriter::WakeIOThread() {
+	if (ioThreadSleeping) {
+		lock_guard<mutex> lock(wakeMutex);
+		wakeCondition.notify_one();
+	}
+}
+
+void AsyncLogWriter::FinishLines(unsigned long long line_count) {
+	finishedLines += line_count;
+	// Counted before checking for waiters, so a thread that starts waiting after this check sees the lines
+	if (threadsWaitingForProgress > 0) {
+		lock_guard<mutex> lock(progressMutex);
+		progressCondition.notify_all();
+	}
+}
+
+// Blocks until more than finished_lines lines have been written or dropped.
+void AsyncLogWriter::WaitForProgress(unsigned long long finished_lines) {
+	unique_lock<mutex> lock(progressMutex);
+	threadsWaitingForProgress++;
+	WakeIOThread();
+	progressCondition.wait(lock, [&]() { return finishedLines > finished_lines; });
+	threadsWaitingForProgress--;
+}
+
+void AsyncLogWriter::RecordQueueDepth() {
+	size_t depth = queue.ApproximateSize();
+	size_t peak = peakQueueDepth;
+	while (depth > peak and !peakQueueDepth.compare_exchange_weak(peak, depth)) {}
+}
@@ -0,0 +1,117 @@
+/**
+* Async Log Writer : Moves log file output off the logging thread.
+*
+* - Producers call Enqueue(..) with finished lines. A dedicated I/O thread drains
+*		the bounded queue and passes each line to the write callback.
+* - When the queue is full, the selected LogQueueFullPolicy decides whether the
+*		producer waits, the oldest queued line is dropped, or the line goes into
+*		an unbounded in-memory overflow list that the I/O thread drains after
+*		the queue. The overflow list is not written to disk, so with GROW a
+*		stalled disk makes memory grow without limit.
+* - The idle callback runs on the I/O thread whenever the queue is empty, e.g.
+*		to apply a time-based flush policy.
+* - Producers blocked on a full queue and WaitUntilDrained() sleep on a
+*		condition variable that the I/O thread signals as it writes lines.
+*
+*
+* @file AsyncLogWriter.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "BoundedLogQueue.h"
+
+
+const size_t DEFAULT_LOG_QUEUE_CAPACITY = 4096;
+
+
+// What Enqueue(..) does when the write queue is full.
+enum class LogQueueFullPolicy {
+	BLOCK,			// Wait for the I/O thread to make room
+	DROP_OLDEST,	// Discard the oldest queued line to make room
+	GROW			// Keep the line in an unbounded in-memory overflow list
+};
+
+
+// A line waiting to be written by the I/O thread.
+struct PendingLogLine {
+	std::string line;
+	bool encrypt = false;	// Encrypt and prefix the line before writing it
+	size_t lineCount = 1;	// Lines in a batch of data points
+	bool rotate = false;	// Start a new log segment before writing the line
+	std::int64_t indexTime = 0;	// Add a time index entry for the line, 0 for none
+};
+
+
+class AsyncLogWriter {
+
+public:
+	AsyncLogWriter(
+		std::function<void(PendingLogLine&)> write_line,
+		std::function<void()> on_idle,
+		size_t queue_capacity = DEFAULT_LOG_QUEUE_CAPACITY,
+		LogQueueFullPolicy policy = LogQueueFullPolicy::BLOCK);
+
+	// Drains all queued lines before stopping the I/O thread.
+	~AsyncLogWriter();
+
+	AsyncLogWriter(const AsyncLogWriter&) = delete;
+	AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+	void Enqueue(PendingLogLine&& pending);
+
+	// Blocks until every line enqueued so far has been written or dropped.
+	void WaitUntilDrained();
+
+	size_t GetQueueDepth() const;
+	size_t GetPeakQueueDepth() const;
+	unsigned long long GetDroppedLineCount() const;
+	// Lines that went into the overflow list (GROW).
+	unsigned long long GetOverflowLineCount() const;
+
+
+private:
+	std::function<void(PendingLogLine&)> writeLine;
+	std::function<void()> onIdle;
+	LogQueueFullPolicy fullPolicy;
+	BoundedLogQueue<PendingLogLine> queue;
+
+	std::mutex overflowMutex;
+	std::deque<PendingLogLine> overflow;
+	std::atomic<bool> overflowPending{ false };
+
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+	std::atomic<bool> ioThreadSleeping{ false };
+	std::atomic<bool> stopRequested{ false };
+
+	std::mutex progressMutex;
+	std::condition_variable progressCondition;
+	std::atomic<size_t> threadsWaitingForProgress{ 0 };
+
+	std::atomic<unsigned long long> enqueuedLines{ 0 };
+	std::atomic<unsigned long long> finishedLines{ 0 };
+	std::atomic<unsigned long long> droppedLines{ 0 };
+	std::atomic<unsigned long long> overflowLines{ 0 };
+	std::atomic<size_t> peakQueueDepth{ 0 };
+
+	std::thread ioThread;
+
+	void IOThreadLoop();
+	bool DrainOnce();
+	void WakeIOThread();
+	void FinishLines(unsigned long long line_count);
+	void WaitForProgress(unsigned long long finished_lines);
+	void RecordQueueDepth();
+
+};
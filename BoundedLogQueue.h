@@ -0,0 +1,107 @@
+/**
+* Bounded Log Queue : Fixed-capacity, lock-free multi-producer/multi-consumer queue
+*	used to hand log lines from logging threads to a background writer.
+*
+* - Capacity is rounded up to a power of two and never grows.
+* - TryPush(..) fails instead of blocking when the queue is full, so callers
+*		decide how to apply back-pressure.
+* - Each cell carries a sequence number (Vyukov's bounded queue), so producers
+*		and consumers only contend on a single atomic index each.
+*
+*
+* @file BoundedLogQueue.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+
+template <typename T>
+class BoundedLogQueue {
+
+public:
+	explicit BoundedLogQueue(size_t capacity) {
+		size_t roundedCapacity = 2;
+		while (roundedCapacity < capacity)
+			roundedCapacity *= 2;
+
+		mask = roundedCapacity - 1;
+		cells.reset(new Cell[roundedCapacity]);
+		for (size_t i = 0; i < roundedCapacity; i++)
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	BoundedLogQueue(const BoundedLogQueue&) = delete;
+	BoundedLogQueue& operator=(const BoundedLogQueue&) = delete;
+
+	// Returns false if the queue is full.
+	bool TryPush(T&& item) {
+		size_t pos = enqueuePos.load(std::memory_order_relaxed);
+		for (;;) {
+			Cell& cell = cells[pos & mask];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(pos);
+			if (difference == 0) {
+				if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					cell.data = std::move(item);
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (difference < 0)
+				return false;
+			else
+				pos = enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	// Returns false if the queue is empty.
+	bool TryPop(T& item) {
+		size_t pos = dequeuePos.load(std::memory_order_relaxed);
+		for (;;) {
+			Cell& cell = cells[pos & mask];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(pos + 1);
+			if (difference == 0) {
+				if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					item = std::move(cell.data);
+					cell.sequence.store(pos + mask + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (difference < 0)
+				return false;
+			else
+				pos = dequeuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	// Number of queued items. Only approximate while other threads are pushing or popping.
+	size_t ApproximateSize() const {
+		size_t enqueued = enqueuePos.load(std::memory_order_relaxed);
+		size_t dequeued = dequeuePos.load(std::memory_order_relaxed);
+		return enqueued > dequeued ? enqueued - dequeued : 0;
+	}
+
+	size_t Capacity() const {
+		return mask + 1;
+	}
+
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		T data;
+	};
+
+	std::unique_ptr<Cell[]> cells;
+	size_t mask = 0;
+	alignas(64) std::atomic<size_t> enqueuePos{ 0 };
+	alignas(64) std::atomic<size_t> dequeuePos{ 0 };
+
+};
@@ -0,0 +1,67 @@
+#include "BufferedLogFile.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+
+BufferedLogFile::~BufferedLogFile() {
+	Close();
+}
+
+bool BufferedLogFile::Flush() {
+	if (file == nullptr)
+		return false;
+	if (buffer.empty())
+		return true;
+
+	size_t written = fwrite(buffer.data(), 1, buffer.size(), file);
+	bool success = written == buffer.size();
+	buffer.erase(0, written);
+	return success;
+}
+
+bool BufferedLogFile::OpenFile(const string& file_path) {
+	file = fopen(file_path.c_str(), "ab");
+	if (file == nullptr)
+		return false;
+
+	// All buffering is done by this class
+	setvbuf(file, nullptr, _IONBF, 0);
+	buffer.reserve(policy.maxBufferedBytes);
+	return true;
+}
+
+void BufferedLogFile::CloseFile() {
+	fclose(file);
+	file = nullptr;
+}
+
+bool BufferedLogFile::IsFileOpen() const {
+	return file != nullptr;
+}
+
+bool BufferedLogFile::AppendPending(const string& text) {
+	buffer += text;
+	return true;
+}
+
+size_t BufferedLogFile::GetPendingBytes() const {
+	return buffer.size();
+}
+
+bool BufferedLogFile::SyncToDisk() {
+#ifdef _WIN32
+	return _commit(_fileno(file)) == 0;
+#else
+	return fdatasync(fileno(file)) == 0;
+#endif
+}
+
+void BufferedLogFile::OnPolicyChanged() {
+	buffer.reserve(policy.maxBufferedBytes);
+}
@@ -0,0 +1,60 @@
+/**
+* Buffered Log File : Keeps a log file open for a whole logging session and
+*	collects written text in a user-space buffer.
+*
+* - Call Open(..) once, then Write(..) as often as needed. Text is only handed
+*		to the operating system when the flush policy says so, when Flush() is
+*		called, or when the file is closed.
+* - The flush policy is a pending-byte limit and a maximum age for the oldest
+*		unflushed byte. Both are checked on every Write(..).
+* - The file is opened in binary append mode, so lines are written byte-for-byte.
+* - The durability mode decides when flushed text is also forced to stable
+*		storage (fdatasync / _commit).
+*
+* Example usage:
+*
+*	BufferedLogFile file;
+*	LogOutputPolicy policy;
+*	policy.maxBufferedBytes = 256 * 1024;
+*	file.SetPolicy(policy);
+*	file.Open("C:/Users/jbutcher/Documents/myLog1.log");
+*	file.Write("PEC,PRF\n");
+*	file.Close();
+*
+*
+* @file BufferedLogFile.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+#include "LogOutputFile.h"
+
+
+class BufferedLogFile : public LogOutputFile {
+
+public:
+	BufferedLogFile() = default;
+	~BufferedLogFile();
+
+	bool Flush() override;
+
+
+protected:
+	bool OpenFile(const std::string& file_path) override;
+	void CloseFile() override;
+	bool IsFileOpen() const override;
+	bool AppendPending(const std::string& text) override;
+	size_t GetPendingBytes() const override;
+	bool SyncToDisk() override;
+	void OnPolicyChanged() override;
+
+
+private:
+	std::FILE* file = nullptr;
+	std::string buffer;
+
+};
@@ -0,0 +1,741 @@
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#include "ColumnarLogFile.h"
+#include "LogSeriesCodec.h"
+
+using namespace std;
+
+
+const char COLUMNAR_FILE_MAGIC[8] = { 'L', 'O', 'G', 'C', 'O', 'L', '0', '2' };
+const char COLUMNAR_FILE_MAGIC_V1[8] = { 'L', 'O', 'G', 'C', 'O', 'L', '0', '1' };
+const uint32_t COLUMNAR_CHUNK_MAGIC = 0x4B4E4843;  // "CHNK"
+const size_t COLUMNAR_FILE_BUFFER_SIZE = 1024 * 1024;
+
+enum ColumnarEncoding : uint8_t {
+	ENCODING_PLAIN = 0,
+	ENCODING_DICTIONARY = 1,
+	ENCODING_XOR = 2,				// FLOAT
+	ENCODING_DELTA_OF_DELTA = 3,	// INT
+	ENCODING_DICTIONARY_RUNS = 4,	// STRING, dictionary with run-length encoded indices
+	ENCODING_TIME_OF_DAY = 5		// STRING, "HH:MM:SS[.fff]" as delta-of-delta encoded ticks
+};
+
+const unsigned int MAX_TIME_OF_DAY_FRACTION_DIGITS = 9;
+
+
+// ----------------------------------------------------------------------------
+// Binary helpers
+
+template <typename T>
+static void AppendPod(string& out, const T& value) {
+	out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void AppendString(string& out, const string& value) {
+	AppendPod(out, uint32_t(value.size()));
+	out += value;
+}
+
+template <typename T>
+static bool ReadPod(FILE* file, T& value) {
+	return fread(&value, sizeof(T), 1, file) == 1;
+}
+
+// Reads values sequentially out of an in-memory payload.
+class PayloadCursor {
+public:
+	PayloadCursor(const char* _data, size_t _size) : data(_data), size(_size) {}
+
+	template <typename T>
+	bool Read(T& value) {
+		if (sizeof(T) > size - position)
+			return false;
+		memcpy(&value, data + position, sizeof(T));
+		position += sizeof(T);
+		return true;
+	}
+
+	bool ReadString(string& value) {
+		uint32_t length = 0;
+		if (!Read(length) or length > size - position)
+			return false;
+		value.assign(data + position, length);
+		position += length;
+		return true;
+	}
+
+	void Skip(size_t bytes) { position += bytes < size - position ? bytes : size - position; }
+
+	const char* Current() const { return data + position; }
+	size_t Remaining() const { return size - position; }
+
+private:
+	const char* data;
+	size_t size;
+	size_t position = 0;
+};
+
+static bool SeekForward(FILE* file, uint64_t bytes) {
+#ifdef _WIN32
+	return _fseeki64(file, (long long)bytes, SEEK_CUR) == 0;
+#else
+	return fseeko(file, (off_t)bytes, SEEK_CUR) == 0;
+#endif
+}
+
+static float ParseFloat(const string& text) {
+	float value = 0.0f;
+	auto result = from_chars(text.data(), text.data() + text.size(), value);
+	if (result.ec != errc() or text.empty())
+		return nanf("");
+	return value;
+}
+
+static int64_t ParseInt(const string& text) {
+	int64_t value = 0;
+	auto result = from_chars(text.data(), text.data() + text.size(), value);
+	if (result.ec != errc() or text.empty())
+		return COLUMNAR_MISSING_INT;
+	return value;
+}
+
+static bool ParseTwoDigits(const char* text, unsigned int& value) {
+	if (text[0] < '0' or text[0] > '9' or text[1] < '0' or text[1] > '9')
+		return false;
+	value = unsigned(text[0] - '0') * 10 + unsigned(text[1] - '0');
+	return true;
+}
+
+// Parses exactly "HH:MM:SS" followed by fraction_digits digits after a '.' (none
+//   if fraction_digits is 0), so that FormatTimeOfDay(..) gives back the same text.
+static bool ParseTimeOfDay(const string& text, unsigned int fraction_digits, int64_t& ticks) {
+	size_t expectedLength = 8 + (fraction_digits > 0 ? 1 + fraction_digits : 0);
+	unsigned int hours = 0, minutes = 0, seconds = 0;
+	if (text.size() != expectedLength or text[2] != ':' or text[5] != ':'
+		or !ParseTwoDigits(&text[0], hours) or !ParseTwoDigits(&text[3], minutes) or !ParseTwoDigits(&text[6], seconds)
+		or minutes > 59 or seconds > 59)
+		return false;
+
+	ticks = (int64_t(hours) * 60 + minutes) * 60 + seconds;
+	if (fraction_digits == 0)
+		return true;
+	if (text[8] != '.')
+		return false;
+	for (size_t i = 9; i < text.size(); i++) {
+		if (text[i] < '0' or text[i] > '9')
+			return false;
+		ticks = ticks * 10 + (text[i] - '0');
+	}
+	return true;
+}
+
+static bool FormatTimeOfDay(int64_t ticks, unsigned int fraction_digits, string& text) {
+	int64_t scale = 1;
+	for (unsigned int i = 0; i < fraction_digits; i++)
+		scale *= 10;
+	if (ticks < 0 or ticks / scale >= 100 * 3600)
+		return false;
+
+	int64_t seconds = ticks / scale;
+	char buffer[32];
+	int length = snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d",
+		int(seconds / 3600), int(seconds / 60 % 60), int(seconds % 60));
+	if (fraction_digits > 0)
+		length += snprintf(buffer + length, sizeof(buffer) - length, ".%0*lld", int(fraction_digits), (long long)(ticks % scale));
+	text.assign(buffer, size_t(length));
+	return true;
+}
+
+
+size_t ColumnarColumnData::Size() const {
+	switch (type) {
+	case LogColumnType::FLOAT: return floats.size();
+	case LogColumnType::INT: return ints.size();
+	default: return strings.size();
+	}
+}
+
+
+// ----------------------------------------------------------------------------
+// Chunk encoder
+
+void ColumnarChunkEncoder::Reset(const vector<ColumnarColumnInfo>& _schema) {
+	schema = _schema;
+	columnBuffers.assign(schema.size(), ColumnBuffer());
+	rowCount = 0;
+}
+
+const vector<ColumnarColumnInfo>& ColumnarChunkEncoder::GetSchema() const {
+	return schema;
+}
+
+bool ColumnarChunkEncoder::AppendRow(const vector<string>& values) {
+	if (values.size() != schema.size())
+		return false;
+
+	for (size_t col = 0; col < schema.size(); col++) {
+		ColumnBuffer& buffer = columnBuffers[col];
+		switch (schema[col].type) {
+		case LogColumnType::FLOAT: buffer.floats.push_back(ParseFloat(values[col])); break;
+		case LogColumnType::INT: buffer.ints.push_back(ParseInt(values[col])); break;
+		default: buffer.strings.push_back(values[col]); break;
+		}
+	}
+	rowCount++;
+	return true;
+}
+
+bool ColumnarChunkEncoder::AppendRow(const LogRow& values) {
+	if (values.Size() != schema.size())
+		return false;
+
+	for (size_t col = 0; col < schema.size(); col++) {
+		ColumnBuffer& buffer = columnBuffers[col];
+		switch (schema[col].type) {
+		case LogColumnType::FLOAT: buffer.floats.push_back(values.GetAsFloat(col)); break;
+		case LogColumnType::INT: buffer.ints.push_back(values.GetAsInt(col, COLUMNAR_MISSING_INT)); break;
+		default:
+			buffer.strings.emplace_back();
+			values.AppendFormatted(col, LOG_PRECISION_SHORTEST, buffer.strings.back());
+			break;
+		}
+	}
+	rowCount++;
+	return true;
+}
+
+size_t ColumnarChunkEncoder::GetRowCount() const {
+	return rowCount;
+}
+
+void ColumnarChunkEncoder::EncodeChunk(string& chunk) {
+	AppendPod(chunk, COLUMNAR_CHUNK_MAGIC);
+	AppendPod(chunk, uint32_t(rowCount));
+	for (size_t col = 0; col < schema.size(); col++)
+		EncodeColumnBlock(chunk, schema[col], columnBuffers[col]);
+	rowCount = 0;
+}
+
+void ColumnarChunkEncoder::EncodeColumnBlock(string& chunk, const ColumnarColumnInfo& column, ColumnBuffer& buffer) {
+	uint8_t encoding = ENCODING_PLAIN;
+	string payload;
+
+	if (column.type == LogColumnType::FLOAT) {
+		EncodeFloatSeries(buffer.floats.data(), buffer.floats.size(), payload);
+		if (payload.size() < buffer.floats.size() * sizeof(float))
+			encoding = ENCODING_XOR;
+		else
+			payload.assign(reinterpret_cast<const char*>(buffer.floats.data()), buffer.floats.size() * sizeof(float));
+		buffer.floats.clear();
+	}
+	else if (column.type == LogColumnType::INT) {
+		EncodeIntSeries(buffer.ints.data(), buffer.ints.size(), payload);
+		if (payload.size() < buffer.ints.size() * sizeof(int64_t))
+			encoding = ENCODING_DELTA_OF_DELTA;
+		else
+			payload.assign(reinterpret_cast<const char*>(buffer.ints.data()), buffer.ints.size() * sizeof(int64_t));
+		buffer.ints.clear();
+	}
+	else {
+		// Build a dictionary and keep whichever encoding is smallest
+		unordered_map<string, uint32_t> dictionaryIndex;
+		vector<const string*> dictionary;
+		vector<uint32_t> indices;
+		size_t plainSize = 0;
+		for (const string& value : buffer.strings) {
+			plainSize += sizeof(uint32_t) + value.size();
+			auto inserted = dictionaryIndex.emplace(value, uint32_t(dictionary.size()));
+			if (inserted.second)
+				dictionary.push_back(&inserted.first->first);
+			indices.push_back(inserted.first->second);
+		}
+
+		string dictionaryPayload;
+		AppendPod(dictionaryPayload, uint32_t(dictionary.size()));
+		for (const string* entry : dictionary)
+			AppendString(dictionaryPayload, *entry);
+
+		string runsPayload = dictionaryPayload;
+		EncodeIndexRuns(indices.data(), indices.size(), runsPayload);
+		size_t dictionarySize = dictionaryPayload.size() + indices.size() * sizeof(uint32_t);
+
+		// A time column is unique on almost every row, so it only shrinks as numbers
+		string timePayload;
+		if (!buffer.strings.empty()) {
+			const string& first = buffer.strings.front();
+			unsigned int fractionDigits = first.size() > 9 ? unsigned(first.size() - 9) : 0;
+			vector<int64_t> ticks(buffer.strings.size());
+			bool allTimes = fractionDigits <= MAX_TIME_OF_DAY_FRACTION_DIGITS;
+			for (size_t row = 0; row < buffer.strings.size() and allTimes; row++)
+				allTimes = ParseTimeOfDay(buffer.strings[row], fractionDigits, ticks[row]);
+			if (allTimes) {
+				AppendPod(timePayload, uint8_t(fractionDigits));
+				EncodeIntSeries(ticks.data(), ticks.size(), timePayload);
+			}
+		}
+
+		if (!timePayload.empty() and timePayload.size() < runsPayload.size() and timePayload.size() < plainSize) {
+			encoding = ENCODING_TIME_OF_DAY;
+			payload = move(timePayload);
+		}
+		else if (runsPayload.size() < dictionarySize and runsPayload.size() < plainSize) {
+			encoding = ENCODING_DICTIONARY_RUNS;
+			payload = move(runsPayload);
+		}
+		else if (dictionarySize < plainSize) {
+			encoding = ENCODING_DICTIONARY;
+			payload = move(dictionaryPayload);
+			payload.append(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t));
+		}
+		else {
+			for (const string& value : buffer.strings)
+				AppendString(payload, value);
+		}
+		buffer.strings.clear();
+	}
+
+	AppendPod(chunk, encoding);
+	AppendPod(chunk, uint64_t(payload.size()));
+	chunk += payload;
+}
+
+
+// ----------------------------------------------------------------------------
+// Decoding
+
+static bool DecodeColumnBlock(uint8_t encoding, const char* payload, size_t payload_size, size_t row_count,
+	ColumnarColumnData& column) {
+	if (column.type == LogColumnType::FLOAT) {
+		if (encoding == ENCODING_XOR)
+			return DecodeFloatSeries(payload, payload_size, row_count, column.floats);
+		if (encoding != ENCODING_PLAIN or payload_size != row_count * sizeof(float))
+			return false;
+		column.floats.resize(row_count);
+		if (row_count > 0)
+			memcpy(column.floats.data(), payload, payload_size);
+		return true;
+	}
+
+	if (column.type == LogColumnType::INT) {
+		if (encoding == ENCODING_DELTA_OF_DELTA)
+			return DecodeIntSeries(payload, payload_size, row_count, column.ints);
+		if (encoding != ENCODING_PLAIN or payload_size != row_count * sizeof(int64_t))
+			return false;
+		column.ints.resize(row_count);
+		if (row_count > 0)
+			memcpy(column.ints.data(), payload, payload_size);
+		return true;
+	}
+
+	PayloadCursor cursor(payload, payload_size);
+	column.strings.reserve(row_count);
+
+	if (encoding == ENCODING_TIME_OF_DAY) {
+		uint8_t fractionDigits = 0;
+		vector<int64_t> ticks;
+		if (!cursor.Read(fractionDigits) or fractionDigits > MAX_TIME_OF_DAY_FRACTION_DIGITS
+			or !DecodeIntSeries(cursor.Current(), cursor.Remaining(), row_count, ticks))
+			return false;
+		column.strings.resize(row_count);
+		for (size_t row = 0; row < row_count; row++) {
+			if (!FormatTimeOfDay(ticks[row], fractionDigits, column.strings[row]))
+				return false;
+		}
+		return true;
+	}
+
+	if (encoding == ENCODING_DICTIONARY or encoding == ENCODING_DICTIONARY_RUNS) {
+		uint32_t dictionaryCount = 0;
+		if (!cursor.Read(dictionaryCount) or dictionaryCount > cursor.Remaining() / sizeof(uint32_t))
+			return false;
+		vector<string> dictionary(dictionaryCount);
+		for (auto& entry : dictionary) {
+			if (!cursor.ReadString(entry))
+				return false;
+		}
+
+		vector<uint32_t> indices;
+		if (encoding == ENCODING_DICTIONARY_RUNS) {
+			if (!DecodeIndexRuns(cursor.Current(), cursor.Remaining(), row_count, indices))
+				return false;
+		}
+		else {
+			indices.resize(row_count);
+			for (auto& index : indices) {
+				if (!cursor.Read(index))
+					return false;
+			}
+		}
+		for (uint32_t index : indices) {
+			if (index >= dictionary.size())
+				return false;
+			column.strings.push_back(dictionary[index]);
+		}
+		return true;
+	}
+
+	if (encoding != ENCODING_PLAIN)
+		return false;
+	for (size_t row = 0; row < row_count; row++) {
+		string value;
+		if (!cursor.ReadString(value))
+			return false;
+		column.strings.push_back(move(value));
+	}
+	return true;
+}
+
+static ColumnarColumnData MakeColumnData(const ColumnarColumnInfo& info) {
+	ColumnarColumnData column;
+	column.name = info.name;
+	column.type = info.type;
+	return column;
+}
+
+// Map each schema column to its slot in the output, or -1 if not requested
+static bool MapRequestedColumns(const vector<ColumnarColumnInfo>& schema, const vector<string>& column_names,
+	vector<int>& output_slot, vector<ColumnarColumnData>& columns) {
+	output_slot.assign(schema.size(), -1);
+	columns.clear();
+	if (column_names.empty()) {
+		for (size_t col = 0; col < schema.size(); col++) {
+			output_slot[col] = int(col);
+			columns.push_back(MakeColumnData(schema[col]));
+		}
+		return true;
+	}
+
+	for (const string& name : column_names) {
+		size_t col = 0;
+		while (col < schema.size() and schema[col].name != name)
+			col++;
+		if (col == schema.size())
+			return false;
+		output_slot[col] = int(columns.size());
+		columns.push_back(MakeColumnData(schema[col]));
+	}
+	return true;
+}
+
+static void AppendChunkColumns(vector<ColumnarColumnData>& chunk_columns, vector<ColumnarColumnData>& columns) {
+	for (size_t slot = 0; slot < columns.size(); slot++) {
+		ColumnarColumnData& source = chunk_columns[slot];
+		ColumnarColumnData& target = columns[slot];
+		target.floats.insert(target.floats.end(), source.floats.begin(), source.floats.end());
+		target.ints.insert(target.ints.end(), source.ints.begin(), source.ints.end());
+		for (auto& value : source.strings)
+			target.strings.push_back(move(value));
+	}
+}
+
+// Decode the requested columns of one in-memory chunk
+static bool DecodeChunk(const string& chunk, const vector<ColumnarColumnInfo>& schema, const vector<int>& output_slot,
+	vector<ColumnarColumnData>& columns) {
+	PayloadCursor cursor(chunk.data(), chunk.size());
+	uint32_t chunkMagic = 0;
+	uint32_t rowCount = 0;
+	if (!cursor.Read(chunkMagic) or chunkMagic != COLUMNAR_CHUNK_MAGIC or !cursor.Read(rowCount))
+		return false;
+
+	vector<ColumnarColumnData> chunkColumns(columns.size());
+	for (size_t col = 0; col < schema.size(); col++) {
+		uint8_t encoding = 0;
+		uint64_t byteLength = 0;
+		if (!cursor.Read(encoding) or !cursor.Read(byteLength) or byteLength > cursor.Remaining())
+			return false;
+		const char* payload = cursor.Current();
+		cursor.Skip(size_t(byteLength));
+		if (output_slot[col] < 0)
+			continue;
+
+		ColumnarColumnData& target = chunkColumns[output_slot[col]];
+		target.type = schema[col].type;
+		if (!DecodeColumnBlock(encoding, payload, size_t(byteLength), rowCount, target))
+			return false;
+	}
+
+	AppendChunkColumns(chunkColumns, columns);
+	return true;
+}
+
+
+// ----------------------------------------------------------------------------
+// Writer
+
+ColumnarLogWriter::~ColumnarLogWriter() {
+	Close();
+}
+
+bool ColumnarLogWriter::Open(const string& file_path, const vector<ColumnarColumnInfo>& schema, size_t rows_per_chunk) {
+	Close();
+
+	file = fopen(file_path.c_str(), "wb");
+	if (file == nullptr)
+		return false;
+	setvbuf(file, nullptr, _IOFBF, COLUMNAR_FILE_BUFFER_SIZE);
+
+	encoder.Reset(schema);
+	rowsPerChunk = rows_per_chunk > 0 ? rows_per_chunk : 1;
+
+	string header(COLUMNAR_FILE_MAGIC, sizeof(COLUMNAR_FILE_MAGIC));
+	AppendPod(header, uint32_t(schema.size()));
+	for (auto& column : schema) {
+		AppendPod(header, uint8_t(column.type));
+		AppendPod(header, uint16_t(column.name.size()));
+		header += column.name;
+	}
+
+	if (fwrite(header.data(), 1, header.size(), file) != header.size()) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool ColumnarLogWriter::IsOpen() const {
+	return file != nullptr;
+}
+
+const vector<ColumnarColumnInfo>& ColumnarLogWriter::GetSchema() const {
+	return encoder.GetSchema();
+}
+
+bool ColumnarLogWriter::AppendRow(const vector<string>& values) {
+	if (file == nullptr or !encoder.AppendRow(values))
+		return false;
+	if (encoder.GetRowCount() >= rowsPerChunk)
+		return FlushChunk();
+	return true;
+}
+
+bool ColumnarLogWriter::AppendRow(const LogRow& values) {
+	if (file == nullptr or !encoder.AppendRow(values))
+		return false;
+	if (encoder.GetRowCount() >= rowsPerChunk)
+		return FlushChunk();
+	return true;
+}
+
+bool ColumnarLogWriter::FlushChunk() {
+	if (file == nullptr)
+		return false;
+	if (encoder.GetRowCount() == 0)
+		return true;
+
+	chunk.clear();
+	encoder.EncodeChunk(chunk);
+
+	bool success = fwrite(chunk.data(), 1, chunk.size(), file) == chunk.size();
+	return fflush(file) == 0 and success;
+}
+
+void ColumnarLogWriter::Close() {
+	if (file == nullptr)
+		return;
+	FlushChunk();
+	fclose(file);
+	file = nullptr;
+}
+
+
+// ----------------------------------------------------------------------------
+// Reader
+
+ColumnarLogReader::~ColumnarLogReader() {
+	Close();
+}
+
+bool ColumnarLogReader::Open(const string& file_path) {
+	Close();
+
+	file = fopen(file_path.c_str(), "rb");
+	if (file == nullptr)
+		return false;
+	setvbuf(file, nullptr, _IOFBF, COLUMNAR_FILE_BUFFER_SIZE);
+
+	char magic[sizeof(COLUMNAR_FILE_MAGIC)];
+	uint32_t columnCount = 0;
+	if (fread(magic, 1, sizeof(magic), file) != sizeof(magic)
+		or (memcmp(magic, COLUMNAR_FILE_MAGIC, sizeof(magic)) != 0 and memcmp(magic, COLUMNAR_FILE_MAGIC_V1, sizeof(magic)) != 0)
+		or !ReadPod(file, columnCount)) {
+		Close();
+		return false;
+	}
+
+	for (uint32_t col = 0; col < columnCount; col++) {
+		uint8_t type = 0;
+		uint16_t nameLength = 0;
+		if (!ReadPod(file, type) or !ReadPod(file, nameLength)) {
+			Close();
+			return false;
+		}
+		ColumnarColumnInfo column;
+		column.type = LogColumnType(type);
+		column.name.resize(nameLength);
+		if (nameLength > 0 and fread(&column.name[0], 1, nameLength, file) != nameLength) {
+			Close();
+			return false;
+		}
+		schema.push_back(column);
+	}
+
+	firstChunkOffset = ftell(file);
+	return true;
+}
+
+void ColumnarLogReader::Close() {
+	if (file != nullptr)
+		fclose(file);
+	file = nullptr;
+	schema.clear();
+}
+
+const vector<ColumnarColumnInfo>& ColumnarLogReader::GetSchema() const {
+	return schema;
+}
+
+bool ColumnarLogReader::ReadColumns(const vector<string>& column_names, vector<ColumnarColumnData>& columns) {
+	if (file == nullptr)
+		return false;
+
+	vector<int> outputSlot;
+	if (!MapRequestedColumns(schema, column_names, outputSlot, columns))
+		return false;
+
+	fseek(file, long(firstChunkOffset), SEEK_SET);
+
+	string payload;
+	for (;;) {
+		uint32_t chunkMagic = 0;
+		uint32_t rowCount = 0;
+		if (!ReadPod(file, chunkMagic) or chunkMagic != COLUMNAR_CHUNK_MAGIC or !ReadPod(file, rowCount))
+			break;
+
+		// Decode into temporaries so a torn chunk does not leave columns with different lengths
+		vector<ColumnarColumnData> chunkColumns(columns.size());
+		bool chunkComplete = true;
+		for (size_t col = 0; col < schema.size() and chunkComplete; col++) {
+			uint8_t encoding = 0;
+			uint64_t byteLength = 0;
+			if (!ReadPod(file, encoding) or !ReadPod(file, byteLength)) {
+				chunkComplete = false;
+				break;
+			}
+
+			if (outputSlot[col] < 0) {
+				chunkComplete = SeekForward(file, byteLength);
+				continue;
+			}
+
+			payload.resize(size_t(byteLength));
+			if (byteLength > 0 and fread(&payload[0], 1, payload.size(), file) != payload.size()) {
+				chunkComplete = false;
+				break;
+			}
+			ColumnarColumnData& target = chunkColumns[outputSlot[col]];
+			target.type = schema[col].type;
+			chunkComplete = DecodeColumnBlock(encoding, payload.data(), payload.size(), rowCount, target);
+		}
+		if (!chunkComplete)
+			break;
+
+		AppendChunkColumns(chunkColumns, columns);
+	}
+
+	return true;
+}
+
+
+// ----------------------------------------------------------------------------
+// In-memory history
+
+void ColumnarLogHistory::Start(const vector<ColumnarColumnInfo>& schema, size_t rows_per_chunk) {
+	lock_guard<mutex> lock(historyMutex);
+	encoder.Reset(schema);
+	rowsPerChunk = rows_per_chunk > 0 ? rows_per_chunk : 1;
+	chunks.clear();
+	encodedRows = 0;
+	encodedBytes = 0;
+	started = true;
+}
+
+void ColumnarLogHistory::Clear() {
+	lock_guard<mutex> lock(historyMutex);
+	encoder.Reset({});
+	chunks.clear();
+	encodedRows = 0;
+	encodedBytes = 0;
+	started = false;
+}
+
+bool ColumnarLogHistory::IsStarted() const {
+	lock_guard<mutex> lock(historyMutex);
+	return started;
+}
+
+vector<ColumnarColumnInfo> ColumnarLogHistory::GetSchema() const {
+	lock_guard<mutex> lock(historyMutex);
+	return encoder.GetSchema();
+}
+
+bool ColumnarLogHistory::AppendRow(const vector<string>& values) {
+	lock_guard<mutex> lock(historyMutex);
+	if (!started or !encoder.AppendRow(values))
+		return false;
+	if (encoder.GetRowCount() >= rowsPerChunk)
+		EncodeCollectedRows();
+	return true;
+}
+
+bool ColumnarLogHistory::AppendRow(const LogRow& values) {
+	lock_guard<mutex> lock(historyMutex);
+	if (!started or !encoder.AppendRow(values))
+		return false;
+	if (encoder.GetRowCount() >= rowsPerChunk)
+		EncodeCollectedRows();
+	return true;
+}
+
+void ColumnarLogHistory::EncodeCollectedRows() {
+	// Caller holds historyMutex
+	encodedRows += encoder.GetRowCount();
+	chunks.emplace_back();
+	encoder.EncodeChunk(chunks.back());
+	chunks.back().shrink_to_fit();
+	encodedBytes += chunks.back().size();
+}
+
+size_t ColumnarLogHistory::GetRowCount() const {
+	lock_guard<mutex> lock(historyMutex);
+	return encodedRows + encoder.GetRowCount();
+}
+
+size_t ColumnarLogHistory::GetBytesInMemory() const {
+	lock_guard<mutex> lock(historyMutex);
+	return encodedBytes;
+}
+
+bool ColumnarLogHistory::ReadColumns(const vector<string>& column_names, vector<ColumnarColumnData>& columns) const {
+	lock_guard<mutex> lock(historyMutex);
+	vector<int> outputSlot;
+	if (!started or !MapRequestedColumns(encoder.GetSchema(), column_names, outputSlot, columns))
+		return false;
+
+	for (const string& chunk : chunks) {
+		if (!DecodeChunk(chunk, encoder.GetSchema(), outputSlot, columns))
+			return false;
+	}
+
+	// Encode a copy of the rows still being collected so they are read the same way
+	if (encoder.GetRowCount() > 0) {
+		ColumnarChunkEncoder pending = encoder;
+		string chunk;
+		pending.EncodeChunk(chunk);
+		if (!DecodeChunk(chunk, encoder.GetSchema(), outputSlot, columns))
+			return false;
+	}
+	return true;
+}
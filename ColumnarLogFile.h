@@ -0,0 +1,218 @@
+/**
+* Columnar Log File : Binary, column-chunked alternative to the comma-separated log.
+*
+* - The file starts with a self-describing schema (column names and types).
+* - Rows are collected in memory and written as chunks. Each chunk stores its
+*		row count followed by one contiguous block per column, so a reader can
+*		skip every column it does not need.
+* - Each column block is stored with whichever encoding is smallest for the
+*		chunk (see LogSeriesCodec.h):
+*		FLOAT columns as 32-bit floats, plainly or XOR-compressed against the
+*		previous value; INT columns as 64-bit integers, plainly or
+*		delta-of-delta encoded; STRING columns plainly, dictionary-encoded
+*		(optionally with run-length encoded indices) or, for times of day
+*		such as "14:03:27.250", as delta-of-delta encoded ticks. Slowly
+*		changing temperatures, currents and powers, regular timestamps and
+*		repeated dates and alarm strings all shrink to a few bits per row.
+* - A value that cannot be parsed as its column type is stored as NaN (FLOAT)
+*		or COLUMNAR_MISSING_INT (INT).
+* - A chunk that was only partially written (e.g. after a crash) is ignored by
+*		the reader; all complete chunks before it remain readable.
+* - ColumnarLogHistory keeps the same encoded chunks in memory instead of in a
+*		file, as a compact typed history of a session.
+*
+* File layout (little-endian):
+*
+*	"LOGCOL02"                          8-byte magic ("LOGCOL01" files, which
+*	                                    only use plain and dictionary blocks,
+*	                                    are still read)
+*	u32 columnCount
+*	columnCount x { u8 type, u16 nameLength, name }
+*	chunks... { u32 "CHNK", u32 rowCount,
+*	            columnCount x { u8 encoding, u64 byteLength, payload } }
+*
+* Example usage:
+*
+*	ColumnarLogReader reader;
+*	if (reader.Open("C:/Logs/myLog1.logc")) {
+*		vector<ColumnarColumnData> columns;
+*		reader.ReadColumns({ "Time", "ActualTemp-SHG" }, columns);
+*	}
+*
+*
+* @file ColumnarLogFile.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "LogRow.h"
+#include "LogSchema.h"
+
+
+const size_t DEFAULT_COLUMNAR_ROWS_PER_CHUNK = 4096;
+const std::int64_t COLUMNAR_MISSING_INT = std::numeric_limits<std::int64_t>::min();
+
+
+struct ColumnarColumnInfo {
+	std::string name;
+	LogColumnType type = LogColumnType::STRING;
+};
+
+
+// Values of one column. Only the vector matching the column type is filled.
+struct ColumnarColumnData {
+	std::string name;
+	LogColumnType type = LogColumnType::STRING;
+	std::vector<float> floats;
+	std::vector<std::int64_t> ints;
+	std::vector<std::string> strings;
+
+	size_t Size() const;
+};
+
+
+// Collects rows column by column and encodes them as chunks. Used by both
+//   ColumnarLogWriter and ColumnarLogHistory.
+class ColumnarChunkEncoder {
+
+public:
+	void Reset(const std::vector<ColumnarColumnInfo>& schema);
+	const std::vector<ColumnarColumnInfo>& GetSchema() const;
+
+	// Append one row given as text. The number of values must match the schema.
+	bool AppendRow(const std::vector<std::string>& values);
+	// Append one typed row, converting values whose type differs from the schema.
+	bool AppendRow(const LogRow& values);
+
+	size_t GetRowCount() const;
+
+	// Append the rows collected so far to chunk as one encoded chunk, and
+	//   start collecting the next one.
+	void EncodeChunk(std::string& chunk);
+
+
+private:
+	struct ColumnBuffer {
+		std::vector<float> floats;
+		std::vector<std::int64_t> ints;
+		std::vector<std::string> strings;
+	};
+
+	std::vector<ColumnarColumnInfo> schema;
+	std::vector<ColumnBuffer> columnBuffers;
+	size_t rowCount = 0;
+
+	void EncodeColumnBlock(std::string& chunk, const ColumnarColumnInfo& column, ColumnBuffer& buffer);
+
+};
+
+
+class ColumnarLogWriter {
+
+public:
+	ColumnarLogWriter() = default;
+	~ColumnarLogWriter();
+
+	ColumnarLogWriter(const ColumnarLogWriter&) = delete;
+	ColumnarLogWriter& operator=(const ColumnarLogWriter&) = delete;
+
+	// Create (or overwrite) the file and write the schema.
+	bool Open(const std::string& file_path, const std::vector<ColumnarColumnInfo>& schema,
+		size_t rows_per_chunk = DEFAULT_COLUMNAR_ROWS_PER_CHUNK);
+	bool IsOpen() const;
+	const std::vector<ColumnarColumnInfo>& GetSchema() const;
+
+	// Append one row given as text. The number of values must match the schema.
+	bool AppendRow(const std::vector<std::string>& values);
+	// Append one typed row, converting values whose type differs from the schema.
+	bool AppendRow(const LogRow& values);
+
+	// Write the rows collected so far as a chunk.
+	bool FlushChunk();
+
+	// Write the last chunk and close the file.
+	void Close();
+
+
+private:
+	std::FILE* file = nullptr;
+	ColumnarChunkEncoder encoder;
+	size_t rowsPerChunk = DEFAULT_COLUMNAR_ROWS_PER_CHUNK;
+	std::string chunk;
+
+};
+
+
+class ColumnarLogReader {
+
+public:
+	ColumnarLogReader() = default;
+	~ColumnarLogReader();
+
+	ColumnarLogReader(const ColumnarLogReader&) = delete;
+	ColumnarLogReader& operator=(const ColumnarLogReader&) = delete;
+
+	// Open the file and read its schema.
+	bool Open(const std::string& file_path);
+	void Close();
+
+	const std::vector<ColumnarColumnInfo>& GetSchema() const;
+
+	// Read the named columns (all columns if column_names is empty) from every
+	//   complete chunk. Columns not requested are skipped without being decoded.
+	//   Returns false if a requested column does not exist.
+	bool ReadColumns(const std::vector<std::string>& column_names, std::vector<ColumnarColumnData>& columns);
+
+
+private:
+	std::FILE* file = nullptr;
+	std::vector<ColumnarColumnInfo> schema;
+	long long firstChunkOffset = 0;
+
+};
+
+
+// Keeps rows in memory as encoded chunks, typically a tenth of the size of the
+//   same rows as text. Thread-safe.
+class ColumnarLogHistory {
+
+public:
+	// Drop all rows and start over with a new schema.
+	void Start(const std::vector<ColumnarColumnInfo>& schema,
+		size_t rows_per_chunk = DEFAULT_COLUMNAR_ROWS_PER_CHUNK);
+	void Clear();
+	bool IsStarted() const;
+	std::vector<ColumnarColumnInfo> GetSchema() const;
+
+	bool AppendRow(const std::vector<std::string>& values);
+	bool AppendRow(const LogRow& values);
+
+	size_t GetRowCount() const;
+	// Encoded chunks only; the rows of the chunk being collected are not counted.
+	size_t GetBytesInMemory() const;
+
+	// Same as ColumnarLogReader::ReadColumns(..), including the rows not yet
+	//   encoded.
+	bool ReadColumns(const std::vector<std::string>& column_names, std::vector<ColumnarColumnData>& columns) const;
+
+
+private:
+	mutable std::mutex historyMutex;
+	bool started = false;
+	ColumnarChunkEncoder encoder;
+	size_t rowsPerChunk = DEFAULT_COLUMNAR_ROWS_PER_CHUNK;
+	std::vector<std::string> chunks;
+	size_t encodedRows = 0;
+	size_t encodedBytes = 0;
+
+	void EncodeCollectedRows();
+
+};
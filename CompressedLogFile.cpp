@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <filesystem>
+
+#include "CompressedLogFile.h"
+#include "LogCompression.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+
+CompressedLogFile::~CompressedLogFile() {
+	Close();
+}
+
+bool CompressedLogFile::Flush() {
+	if (file == nullptr)
+		return false;
+
+	while (!buffer.empty()) {
+		string block;
+		if (buffer.size() <= LOG_COMPRESSION_BLOCK_SIZE) {
+			block = move(buffer);
+			buffer = string();
+			buffer.reserve(policy.maxBufferedBytes);
+		}
+		else {
+			block = buffer.substr(0, LOG_COMPRESSION_BLOCK_SIZE);
+			buffer.erase(0, LOG_COMPRESSION_BLOCK_SIZE);
+		}
+
+		unique_lock<mutex> lock(blocksMutex);
+		blocksChanged.wait(lock, [this]() { return blocks.size() < MAX_QUEUED_COMPRESSED_BLOCKS; });
+		blocks.push_back(move(block));
+		blocksChanged.notify_all();
+	}
+
+	lock_guard<mutex> lock(blocksMutex);
+	return !writeFailed;
+}
+
+uint64_t CompressedLogFile::GetBytesWritten() const {
+	// The worker adds the stored bytes first, so a block finished in between is counted twice, never missed
+	uint64_t textBytes = compressedTextBytes;
+	uint64_t storedBytes = storedBlockBytes;
+	uint64_t fileStoredBytes = storedBytes - storedBytesAtOpen;
+	uint64_t uncompressedBytes = LogOutputFile::GetBytesWritten() - (textBytes - textBytesAtOpen);
+	// No ratio to estimate from until the first block is written. Earlier
+	//   files count too, so a new file does not start without one.
+	if (textBytes == 0)
+		return fileStoredBytes;
+	return fileStoredBytes + uint64_t(double(uncompressedBytes) * double(storedBytes) / double(textBytes));
+}
+
+bool CompressedLogFile::OpenFile(const string& file_path) {
+	error_code sizeError;
+	uintmax_t existingBytes = filesystem::file_size(file_path, sizeError);
+	bool newFile = sizeError or existingBytes == 0;
+	if (!newFile and !TrimTornBlocks(file_path))
+		return false;
+
+	file = fopen(file_path.c_str(), "ab");
+	if (file == nullptr)
+		return false;
+	if (newFile and !WriteCompressedLogFileHeader(file)) {
+		fclose(file);
+		file = nullptr;
+		return false;
+	}
+
+	buffer.reserve(policy.maxBufferedBytes);
+	stopRequested = false;
+	writeFailed = false;
+	textBytesAtOpen = compressedTextBytes;
+	storedBytesAtOpen = storedBlockBytes;
+	compressorThread = thread(&CompressedLogFile::CompressorThreadLoop, this);
+	return true;
+}
+
+void CompressedLogFile::CloseFile() {
+	{
+		lock_guard<mutex> lock(blocksMutex);
+		stopRequested = true;
+	}
+	blocksChanged.notify_all();
+	if (compressorThread.joinable())
+		compressorThread.join();
+
+	fclose(file);
+	file = nullptr;
+}
+
+bool CompressedLogFile::IsFileOpen() const {
+	return file != nullptr;
+}
+
+bool CompressedLogFile::AppendPending(const string& text) {
+	buffer += text;
+	return true;
+}
+
+size_t CompressedLogFile::GetPendingBytes() const {
+	return buffer.size();
+}
+
+bool CompressedLogFile::SyncToDisk() {
+	WaitUntilCompressed();
+	{
+		lock_guard<mutex> lock(blocksMutex);
+		if (writeFailed)
+			return false;
+	}
+#ifdef _WIN32
+	return _commit(_fileno(file)) == 0;
+#else
+	return fdatasync(fileno(file)) == 0;
+#endif
+}
+
+void CompressedLogFile::OnPolicyChanged() {
+	buffer.reserve(policy.maxBufferedBytes);
+}
+
+void CompressedLogFile::CompressorThreadLoop() {
+	string scratch;
+	unique_lock<mutex> lock(blocksMutex);
+	while (true) {
+		blocksChanged.wait(lock, [this]() { return stopRequested or !blocks.empty(); });
+		// Blocks still queued are written before stopping
+		if (blocks.empty())
+			return;
+
+		string block = move(blocks.front());
+		blocks.pop_front();
+		compressing = true;
+		blocksChanged.notify_all();
+		lock.unlock();
+
+		size_t storedBytes = 0;
+		bool written = WriteCompressedLogBlock(file, block.data(), block.size(), scratch, &storedBytes)
+			and fflush(file) == 0;
+		storedBlockBytes += storedBytes;
+		compressedTextBytes += block.size();
+
+		lock.lock();
+		compressing = false;
+		if (!written)
+			writeFailed = true;
+		blocksChanged.notify_all();
+	}
+}
+
+void CompressedLogFile::WaitUntilCompressed() {
+	unique_lock<mutex> lock(blocksMutex);
+	blocksChanged.wait(lock, [this]() { return blocks.empty() and !compressing; });
+}
+
+bool CompressedLogFile::TrimTornBlocks(const string& file_path) {
+	// An existing file must be a compressed log. A torn last block is cut off
+	// so new blocks follow the last intact one.
+	FILE* existing = fopen(file_path.c_str(), "rb");
+	if (existing == nullptr)
+		return false;
+	if (!ReadCompressedLogFileHeader(existing)) {
+		fclose(existing);
+		return false;
+	}
+
+	long intactEnd = ftell(existing);
+	string block, scratch;
+	bool corrupt = false;
+	while (ReadCompressedLogBlock(existing, block, scratch, corrupt))
+		intactEnd = ftell(existing);
+	fclose(existing);
+
+	if (corrupt) {
+		error_code resizeError;
+		filesystem::resize_file(file_path, uintmax_t(intactEnd), resizeError);
+		return !resizeError;
+	}
+	return true;
+}
+
+
+CompressedLogReader::~CompressedLogReader() {
+	Close();
+}
+
+bool CompressedLogReader::Open(const string& file_path) {
+	Close();
+	file = fopen(file_path.c_str(), "rb");
+	if (file == nullptr)
+		return false;
+	if (!ReadCompressedLogFileHeader(file)) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void CompressedLogReader::Close() {
+	if (file != nullptr)
+		fclose(file);
+	file = nullptr;
+	block.clear();
+	position = 0;
+	corrupt = false;
+}
+
+bool CompressedLogReader::ReadLine(string& line) {
+	line.clear();
+	if (file == nullptr)
+		return false;
+
+	// A line may continue in the next block
+	while (true) {
+		size_t end = block.find('\n', position);
+		if (end != string::npos) {
+			line.append(block, position, end - position);
+			position = end + 1;
+			break;
+		}
+		line.append(block, position, string::npos);
+		position = 0;
+		if (!ReadCompressedLogBlock(file, block, scratch, corrupt)) {
+			block.clear();
+			return !line.empty();
+		}
+	}
+
+	if (!line.empty() and line.back() == '\r')
+		line.pop_back();
+	return true;
+}
+
+bool CompressedLogReader::FoundCorruptBlock() const {
+	return corrupt;
+}
@@ -0,0 +1,124 @@
+/**
+* Compressed Log File : Keeps a log file open for a whole logging session and
+*	writes it as independently compressed blocks (see LogCompression.h).
+*
+* - Text is collected like in BufferedLogFile. Every flush seals the pending
+*		text into one block, and a worker thread compresses and appends it, so
+*		the logging thread never waits for compression.
+* - Each block is decodable on its own. After a crash at most the blocks not
+*		yet written are lost; a torn last block is cut off when the file is
+*		opened again, and new blocks are appended after the last intact one.
+* - The block size follows the flush policy (maxBufferedBytes), capped at
+*		LOG_COMPRESSION_BLOCK_SIZE. Larger blocks compress better, smaller
+*		blocks lose less on a crash.
+* - GetBytesWritten() counts blocks that were already written at their
+*		compressed size, and estimates text still waiting to be compressed
+*		from the compression ratio so far.
+* - Read the file back with CompressedLogReader, or restore it to plain text
+*		with DecompressLogFile(..).
+*
+* Example usage:
+*
+*	CompressedLogReader reader;
+*	reader.Open("C:/Users/jbutcher/Documents/myLog1.log");
+*	std::string line;
+*	while (reader.ReadLine(line))
+*		std::cout << line << std::endl;
+*
+*
+* @file CompressedLogFile.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "LogOutputFile.h"
+
+
+// Sealed blocks waiting for the worker thread before a flush has to wait.
+const size_t MAX_QUEUED_COMPRESSED_BLOCKS = 8;
+
+
+class CompressedLogFile : public LogOutputFile {
+
+public:
+	CompressedLogFile() = default;
+	~CompressedLogFile();
+
+	// Seal pending text into a block and hand it to the worker thread.
+	bool Flush() override;
+
+	std::uint64_t GetBytesWritten() const override;
+
+
+protected:
+	bool OpenFile(const std::string& file_path) override;
+	void CloseFile() override;
+	bool IsFileOpen() const override;
+	bool AppendPending(const std::string& text) override;
+	size_t GetPendingBytes() const override;
+	// Waits until every sealed block has been written, then syncs.
+	bool SyncToDisk() override;
+	void OnPolicyChanged() override;
+
+
+private:
+	std::FILE* file = nullptr;
+	std::string buffer;
+
+	std::mutex blocksMutex;
+	std::condition_variable blocksChanged;
+	std::deque<std::string> blocks;
+	bool compressing = false;
+	bool stopRequested = false;
+	bool writeFailed = false;
+	std::thread compressorThread;
+	// Text written as blocks by this object, before and after compression
+	std::atomic<std::uint64_t> compressedTextBytes{ 0 };
+	std::atomic<std::uint64_t> storedBlockBytes{ 0 };
+	std::uint64_t textBytesAtOpen = 0;
+	std::uint64_t storedBytesAtOpen = 0;
+
+	void CompressorThreadLoop();
+	void WaitUntilCompressed();
+	static bool TrimTornBlocks(const std::string& file_path);
+
+};
+
+
+class CompressedLogReader {
+
+public:
+	CompressedLogReader() = default;
+	~CompressedLogReader();
+
+	CompressedLogReader(const CompressedLogReader&) = delete;
+	CompressedLogReader& operator=(const CompressedLogReader&) = delete;
+
+	bool Open(const std::string& file_path);
+	void Close();
+
+	// Read the next line, without its line ending. Returns false once all
+	//   intact blocks have been read.
+	bool ReadLine(std::string& line);
+
+	// True if reading stopped at a torn or corrupt block.
+	bool FoundCorruptBlock() const;
+
+
+private:
+	std::FILE* file = nullptr;
+	std::string block;
+	std::string scratch;
+	size_t position = 0;
+	bool corrupt = false;
+
+};
@@ -0,0 +1,124 @@
+/**
+* Copy-On-Write Log Value : A value that one thread reads all the time and
+*	other threads rarely change, e.g. the observer lists of a logger.
+*
+* - Readers never wait for updates. Read() returns a guard that points at the
+*		current version, which stays valid and unchanged while the guard lives.
+* - Update(..) copies the current version, changes the copy, and swaps it in.
+*		Updates are serialized with a mutex that readers never touch.
+* - Old versions are deleted as soon as no reader is active: by the update
+*		itself, or else by the last reader to leave. Anything an old version
+*		owns (e.g. an observer that was just removed) therefore lives until the
+*		readers that could see it are done, and may be destroyed on a reader's
+*		thread.
+* - A reader may call Update(..) from inside a Read() guard; the change
+*		applies from the next Read().
+*
+* Example usage:
+*
+*	CopyOnWriteLogValue<std::vector<int>> values;
+*	values.Update([](std::vector<int>& v) { v.push_back(1); });
+*	{
+*		auto current = values.Read();
+*		for (int value : *current)
+*			...
+*	}
+*
+*
+* @file CopyOnWriteLogValue.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+
+template <typename T>
+class CopyOnWriteLogValue {
+
+public:
+	class ReadGuard {
+	public:
+		ReadGuard(const ReadGuard&) = delete;
+		ReadGuard& operator=(const ReadGuard&) = delete;
+		~ReadGuard() {
+			if (owner.readers.fetch_sub(1, std::memory_order_seq_cst) == 1
+				and owner.retiredCount.load(std::memory_order_seq_cst) > 0)
+				owner.DeleteRetiredIfUnread();
+		}
+
+		const T& operator*() const { return *value; }
+		const T* operator->() const { return value; }
+
+	private:
+		friend class CopyOnWriteLogValue;
+
+		const CopyOnWriteLogValue& owner;
+		const T* value;
+
+		explicit ReadGuard(const CopyOnWriteLogValue& _owner) : owner(_owner) {
+			// Counted before loading, so an update that swaps after the load sees this reader
+			owner.readers.fetch_add(1, std::memory_order_seq_cst);
+			value = owner.current.load(std::memory_order_seq_cst);
+		}
+	};
+
+	CopyOnWriteLogValue() : current(new T()) {}
+	~CopyOnWriteLogValue() {
+		delete current.load();
+		for (T* old : retired)
+			delete old;
+	}
+
+	CopyOnWriteLogValue(const CopyOnWriteLogValue&) = delete;
+	CopyOnWriteLogValue& operator=(const CopyOnWriteLogValue&) = delete;
+
+	ReadGuard Read() const { return ReadGuard(*this); }
+
+	// Call modify(T&) on a copy of the current version, then make the copy
+	//   current. Must not be called from inside modify.
+	template <typename Modify>
+	void Update(Modify&& modify) {
+		std::lock_guard<std::mutex> lock(updateMutex);
+		T* next = new T(*current.load(std::memory_order_seq_cst));
+		modify(*next);
+		T* old = current.exchange(next, std::memory_order_seq_cst);
+		{
+			std::lock_guard<std::mutex> retiredLock(retiredMutex);
+			retired.push_back(old);
+			retiredCount.store(retired.size(), std::memory_order_seq_cst);
+		}
+		DeleteRetiredIfUnread();
+	}
+
+
+private:
+	std::atomic<T*> current;
+	mutable std::atomic<size_t> readers{ 0 };
+	std::mutex updateMutex;
+	// Only held to move versions in or out, so the last reader never waits for an update
+	mutable std::mutex retiredMutex;
+	mutable std::vector<T*> retired;
+	mutable std::atomic<size_t> retiredCount{ 0 };
+
+	// Versions are retired only after they were swapped out, so readers that
+	//   start after no reader was seen can only get the current version.
+	void DeleteRetiredIfUnread() const {
+		std::vector<T*> unread;
+		{
+			std::lock_guard<std::mutex> lock(retiredMutex);
+			if (readers.load(std::memory_order_seq_cst) != 0)
+				return;
+			unread.swap(retired);
+			retiredCount.store(0, std::memory_order_seq_cst);
+		}
+		// Outside the lock, since deleting a version can release observers
+		for (T* old : unread)
+			delete old;
+	}
+
+};
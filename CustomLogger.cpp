@@ -25,12 +25,14 @@ const unsigned int DEFAULT_LOG_TIME_INTERVAL_IN_S = 60;
 //	- switching the category ON/OFF for being included in the log
 // 
 // You can arbitrarily control which laser parameters are included in a category
-// by choosing the names returned by GetColumnNames() and the values returned
-// by GetValues(). The only requirement is that the number of items returned in each
+// by choosing the names returned by GetColumnNames() and the values appended
+// by AppendValues(). The only requirement is that the number of items in each
 // must match, otherwise logging the data point will fail.
 //
 // Create a new category by deriving from this class and overriding the
-// 3 virtual methods: GetName(), GetColumnNames(), and GetValues().
+// 3 virtual methods: GetName(), GetColumnNames(), and AppendValues().
+// Override GetColumnFormats() as well if some values are not floats with
+// 2 decimal places, and GetColumnUnits() if the values have a unit.
 // See the child classes below for examples.
 class LaserStateLogCategory {
 
@@ -49,9 +51,21 @@ public:
 	// E.g., { "SHG", "THG", "LDD" }
 	virtual vector<string> GetColumnNames() const = 0;
 
-	// Get the string values from this category to be put in the log.
-	// E.g., { "49.5", "51.3", "27.8" }
-	virtual vector<string> GetValues() const = 0;
+	// Append the values from this category to the row to be logged.
+	// E.g., 49.5f, 51.3f, 27.8f
+	virtual void AppendValues(LogRow& row) const = 0;
+
+	// Get the type and text precision of each column, in the same order as
+	// GetColumnNames(). Default: every column is a float with 2 decimal places.
+	virtual vector<LogColumnFormat> GetColumnFormats() const {
+		return vector<LogColumnFormat>(GetColumnNames().size(), { LogColumnType::FLOAT, 2 });
+	}
+
+	// Get the unit of each column, in the same order as GetColumnNames(), for
+	// typed observers. Default: no units.
+	virtual vector<string> GetColumnUnits() const {
+		return vector<string>(GetColumnNames().size(), "");
+	}
 
 	// Include this category in the log.
 	void Include() { isIncluded = true; };
@@ -89,12 +103,14 @@ public:
 		return columnNames;
 	}
 
-	vector<string> GetValues() const override {
-		vector<string> values;
+	void AppendValues(LogRow& row) const override {
 		lc->RefreshPowerMonitorReadings();
 		for (int id : lc->GetPowerMonitorIDs())
-			values.push_back(to_string_with_precision(lc->GetPowerMonitorReadingInWatts(id), 2));
-		return values;
+			row.AddFloat(lc->GetPowerMonitorReadingInWatts(id));
+	}
+
+	vector<string> GetColumnUnits() const override {
+		return vector<string>(GetColumnNames().size(), "W");
 	}
 };
 
@@ -120,14 +136,12 @@ public:
 		return columnNames;
 	}
 
-	vector<string> GetValues() const override {
-		vector<string> values;
+	void AppendValues(LogRow& row) const override {
 		lc->RefreshLDDReadings();
 		for (int id : lc->GetLddIds()) {
-			values.push_back(to_string_with_precision(lc->GetLDDSetCurrent(id), 2));
-			values.push_back(to_string_with_precision(lc->GetLDDActualCurrent(id), 2));
+			row.AddFloat(lc->GetLDDSetCurrent(id));
+			row.AddFloat(lc->GetLDDActualCurrent(id));
 		}
-		return values;
 	}
 };
 
@@ -155,16 +169,14 @@ public:
 		return columnNames;
 	}
 
-	vector<string> GetValues() const override {
-		vector<string> values;
+	void AppendValues(LogRow& row) const override {
 		lc->RefreshTemperatureReadings();
 		for (int id : lc->GetTemperatureControlIDs()) {
 			if (lc->TemperatureControlIsSettable(id)) {
-				values.push_back(to_string_with_precision(lc->GetSetTemperature(id), 2));
+				row.AddFloat(lc->GetSetTemperature(id));
 			}
-			values.push_back(to_string_with_precision(lc->GetActualTemperature(id), 2));
+			row.AddFloat(lc->GetActualTemperature(id));
 		}
-		return values;
 	}
 };
 // ----------------------------------------------------------------------------
@@ -189,16 +201,22 @@ public:
 		return columnNames;
 	}
 
-	vector<string> GetValues() const override {
-		vector<string> values;
+	vector<LogColumnFormat> GetColumnFormats() const override {
+		return vector<LogColumnFormat>(GetColumnNames().size(), { LogColumnType::FLOAT, 3 });
+	}
+
+	vector<string> GetColumnUnits() const override {
+		return vector<string>(GetColumnNames().size(), "V");
+	}
+
+	void AppendValues(LogRow& row) const override {
 		lc->RefreshTECVoltageAndCurrentReadings();
 		for (int id : lc->GetTemperatureControlIDs()) {
 			if (!lc->TemperatureControlIsThermistorOnly(id)) {
 				float voltage = lc->GetTECVoltage(id);
-				values.push_back(to_string_with_precision(voltage, 3));
+				row.AddFloat(voltage);
 			}
 		}
-		return values;
 	}
 };
 
@@ -224,16 +242,22 @@ public:
 		return columnNames;
 	}
 
-	vector<string> GetValues() const override {
-		vector<string> values;
+	vector<LogColumnFormat> GetColumnFormats() const override {
+		return vector<LogColumnFormat>(GetColumnNames().size(), { LogColumnType::FLOAT, 3 });
+	}
+
+	vector<string> GetColumnUnits() const override {
+		return vector<string>(GetColumnNames().size(), "A");
+	}
+
+	void AppendValues(LogRow& row) const override {
 		lc->RefreshTECVoltageAndCurrentReadings();
 		for (int id : lc->GetTemperatureControlIDs()) {
 			if (!lc->TemperatureControlIsThermistorOnly(id)) {
 				float current = lc->GetTECCurrent(id);
-				values.push_back(to_string_with_precision(current, 3));
+				row.AddFloat(current);
 			}
 		}
-		return values;
 	}
 };
 // ----------------------------------------------------------------------------
@@ -258,18 +282,24 @@ public:
 		return columnNames;
 	}
 
-	vector<string> GetValues() const override {
-		vector<string> values;
+	vector<LogColumnFormat> GetColumnFormats() const override {
+		return vector<LogColumnFormat>(GetColumnNames().size(), { LogColumnType::FLOAT, 3 });
+	}
+
+	vector<string> GetColumnUnits() const override {
+		return vector<string>(GetColumnNames().size(), "W");
+	}
+
+	void AppendValues(LogRow& row) const override {
 		lc->RefreshTECVoltageAndCurrentReadings();
 		for (int id : lc->GetTemperatureControlIDs()) {
 			if (!lc->TemperatureControlIsThermistorOnly(id)) {
 				float current = lc->GetTECCurrent(id);
 				float voltage = lc->GetTECVoltage(id);
 				float power = abs(current * voltage);
-				values.push_back(to_string_with_precision(power, 3));
+				row.AddFloat(power);
 			}
 		}
-		return values;
 	}
 };
 
@@ -300,13 +330,22 @@ public:
 		return columnNames;
 	}
 
-	vector<string> GetValues() const override {
-		vector<string> values;
+	vector<LogColumnFormat> GetColumnFormats() const override {
+		vector<LogColumnFormat> formats;
+		if (lc->ChillerFlowIsEnabledForUse())
+			formats.push_back({ LogColumnType::FLOAT, 1 });
+		// Humidity readings are doubles, which a float column would round. They
+		//   are kept as text, formatted as they always were.
+		for (size_t i = 0; i < lc->GetHumidityIds().size(); i++)
+			formats.push_back({ LogColumnType::STRING });
+		return formats;
+	}
 
+	void AppendValues(LogRow& row) const override {
 		// Chiller flow
 		if (lc->ChillerFlowIsEnabledForUse()) {
 			lc->RefreshFlowReadings();
-			values.push_back(to_string_with_precision(lc->GetChillerFlowReading(), 1));
+			row.AddFloat(lc->GetChillerFlowReading());
 		}
 
 		// Humidity
@@ -314,11 +353,9 @@ public:
 		if (humidityIds.size() != 0) {
 			lc->RefreshHumidityReadings();
 			for (int id : humidityIds) {
-				values.push_back(to_string(lc->GetHumidityReading(id)));
+				row.AddString(to_string(lc->GetHumidityReading(id)));
 			}
 		}
-
-		return values;
 	}
 };
 
@@ -339,11 +376,15 @@ public:
 		};
 	}
 
-	vector<string> GetValues() const override {
-		vector<string> values;
-		values.push_back(to_string(lc->GetPRF()));
-		values.push_back(to_string_with_precision(lc->GetPEC(), 2));
-		return values;
+	// The PRF is a double, and at 1e5 - 1e6 Hz a float does not keep all its
+	//   digits, so it is kept as text, formatted as it always was.
+	vector<LogColumnFormat> GetColumnFormats() const override {
+		return { { LogColumnType::STRING }, { LogColumnType::FLOAT, 2 } };
+	}
+
+	void AppendValues(LogRow& row) const override {
+		row.AddString(to_string(lc->GetPRF()));
+		row.AddFloat(lc->GetPEC());
 	}
 };
 
@@ -367,15 +408,17 @@ public:
 		return columnNames;
 	}
 
-	vector<string> GetValues() const override {
-		vector<string> values;
+	vector<LogColumnFormat> GetColumnFormats() const override {
+		return vector<LogColumnFormat>(lc->GetMotorIDs().size(), { LogColumnType::INT });
+	}
+
+	void AppendValues(LogRow& row) const override {
 		auto motorIds = lc->GetMotorIDs();
 		if (motorIds.size() != 0) {
 			lc->RefreshMotorReadings();
 			for (int id : motorIds)
-				values.push_back(to_string(lc->GetMotorIndex(id)));
+				row.AddInt(lc->GetMotorIndex(id));
 		}
-		return values;
 	}
 };
 
@@ -391,19 +434,19 @@ public:
 
 	vector<string> GetColumnNames() const override { return { "Alarms" }; };
 
-	vector<string> GetValues() const override {
-		// Returns a single value: either an empty string or a string of one or more alarms
-		vector<string> values;
+	vector<LogColumnFormat> GetColumnFormats() const override { return { { LogColumnType::STRING } }; };
+
+	void AppendValues(LogRow& row) const override {
+		// Appends a single value: either an empty string or a string of one or more alarms
 		lc->RefreshVitalStatusReadings();
 		if (lc->HasSoftFault() or lc->HasHardFault()) {
 			string faultsMessage = "";
 			for (string& fault : lc->GetAllCurrentFaults())
 				faultsMessage += bracketize(fault);
-			values.push_back(faultsMessage);
+			row.AddString(faultsMessage);
 		}
 		else
-			values.push_back("");
-		return values;
+			row.AddString("");
 	}
 };
 
@@ -429,6 +472,8 @@ private:
 				LogDataPoint();
 				totalLoggedDataPointsInThisThread++;
 			}
+			// Lines logged between ticks would otherwise wait for the next data point
+			l.FlushIfDue();
 
 			this_thread::sleep_for(chrono::seconds(1));
 		}
@@ -438,18 +483,21 @@ private:
 	void LogDataPoint() {
 		if (!lc->IsConnected())
 			return;
-		vector<string> values;
-		for (auto& category : categories) {
-			if (category->IsIncluded()) {
-
-				if (!lc->IsConnected() or lc->IsResetting() or lc->IsUpdating())
-					return;
-
-				vector<string> categoryValues = category->GetValues();
-				values.insert(values.end(), categoryValues.begin(), categoryValues.end());
+		// Reused for every data point so its storage is only allocated once
+		row.Clear();
+		{
+			LogStageTimer timer(l.stageTimings, LogStage::READ_VALUES);
+			for (auto& category : categories) {
+				if (category->IsIncluded()) {
+
+					if (!lc->IsConnected() or lc->IsResetting() or lc->IsUpdating())
+						return;
+
+					category->AppendValues(row);
+				}
 			}
 		}
-		l.LogDataPoint(values);
+		l.LogDataPoint(row);
 		totalLoggedDataPoints++;
 	}
 
@@ -486,6 +534,7 @@ public:
 	unsigned int totalLoggedDataPoints = 0;
 	shared_ptr<thread> loggingThread = nullptr;
 	bool isLogging = false;
+	LogRow row;
 
 	void InitLoggingThread() {
 		if (loggingThread != nullptr) {
@@ -513,6 +562,12 @@ string CustomLogger::GetCategoryName(LaserStateLogCategoryEnum _category) {
 	return impl->mapEnumToCategory.at(_category)->GetName();
 }
 
+LogColumnFilter CustomLogger::GetCategoryFilter(LaserStateLogCategoryEnum _category) {
+	LogColumnFilter filter;
+	filter.categories.push_back(GetCategoryName(_category));
+	return filter;
+}
+
 void CustomLogger::IncludeCategory(LaserStateLogCategoryEnum _category) {
 	auto& category = impl->mapEnumToCategory.at(_category);
 	category->Include();
@@ -539,12 +594,21 @@ unsigned int CustomLogger::GetTimeIntervalInSeconds() const {
 void CustomLogger::Start() {
 	// Add columns for included categories
 	columnNames.clear();
+	columnFormats.clear();
+	columnCategories.clear();
+	columnUnits.clear();
 	AddColumn("Date");
 	AddColumn("Time");
 	for (auto& category : impl->categories) {
 		if (category->IsIncluded()) {
-			for (const string& columnName : category->GetColumnNames())
-				AddColumn(columnName);
+			vector<string> categoryColumnNames = category->GetColumnNames();
+			vector<LogColumnFormat> categoryColumnFormats = category->GetColumnFormats();
+			vector<string> categoryColumnUnits = category->GetColumnUnits();
+			for (size_t col = 0; col < categoryColumnNames.size(); col++) {
+				LogColumnFormat format = col < categoryColumnFormats.size() ? categoryColumnFormats[col] : LogColumnFormat();
+				string unit = col < categoryColumnUnits.size() ? categoryColumnUnits[col] : "";
+				AddColumn(categoryColumnNames[col], format.type, format.precision, category->GetName(), unit);
+			}
 		}
 	}
 	if (GetTotalLoggedDataPoints() == 0)
@@ -566,9 +630,10 @@ void CustomLogger::Reset() {
 	impl->totalLoggedDataPoints = 0;
 
 	// Clear file contents
+	Flush();
 	logFile.open(impl->logFilePath, ofstream::out | ofstream::trunc); // Update to use logFilePath
 	logFile.close();
-	logDataInMemory.clear();
+	logDataInMemory.Clear();
 
 	if (IsLogging())
 		WriteHeaderLine();
@@ -69,6 +69,10 @@ public:
 
 	LOG_API std::string GetCategoryName(LaserStateLogCategoryEnum _category);
 
+	// Filter for observers that only want the columns of one category
+	// (see LogNotifier::addObserver(..)).
+	LOG_API LogColumnFilter GetCategoryFilter(LaserStateLogCategoryEnum _category);
+
 	// Include a category of laser parameters to log.
 	// CustomLogger begins with no categories added.
 	LOG_API void IncludeCategory(LaserStateLogCategoryEnum _category);
@@ -42,8 +42,24 @@ void GraphingWork::SetupGraph() {
     graphPlot_->SetMinSize(wxSize(1100, 700));
 
     // Continue with observer and layout setup
-    RealTimeObserver* tempObserverForWindow = new RealTimeObserver(realTimeLogTextCtrl_, graphPlot_);
-    logger_->addObserver(tempObserverForWindow);
+    // The observer updates widgets, so it runs on the GUI thread, not the logging
+    //   thread. Only the newest data point of a burst is drawn.
+    wxWindow* parent = parent_;
+    graphObserver_ = logger_->addQueuedObserver(std::shared_ptr<TypedLogObserver>(std::make_shared<RealTimeObserver>(realTimeLogTextCtrl_, graphPlot_)),
+        [parent](std::shared_ptr<QueuedLogObserver> queued) {
+            parent->CallAfter([queued]() { queued->Drain(); });
+        }, LogDispatchCoalescing::LATEST);
+
+    // The observer refers to this window's widgets, so it must stop before the
+    //   window is destroyed. Closing the queue on the GUI thread makes drains that
+    //   are already scheduled do nothing. Logging carries on without it.
+    std::shared_ptr<CustomLogger> logger = logger_;
+    std::shared_ptr<QueuedLogObserver> queued = graphObserver_;
+    graphWindow_->Bind(wxEVT_CLOSE_WINDOW, [logger, queued](wxCloseEvent& event) {
+        logger->removeQueuedObserver(queued);
+        queued->Close();
+        event.Skip();
+        });
 
     // Set up layout
     wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
@@ -23,6 +23,7 @@ private:
 
     wxFrame* graphWindow_;
     GraphPlotting* graphPlot_;
+    std::shared_ptr<QueuedLogObserver> graphObserver_;  // Removed when the graph window closes
 
     void SetupGraph();  // Internal function to create checkboxes and initialize graphPlot
 };
\ No newline at end of file
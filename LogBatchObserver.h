@@ -0,0 +1,32 @@
+/**
+* Log Batch Observer : Optional interface for log observers that want a
+*	whole batch of data points logged by LoggerBase::LogDataPoints(..) in
+*	a single call.
+*
+* - Derive an observer from both LogObserver and LogBatchObserver, then add it
+*		to the logger as usual with addObserver(..).
+* - Observers that do not implement this interface receive one
+*		onDataPointLogged(..) call per data point instead.
+*
+*
+* @file LogBatchObserver.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+class LogBatchObserver {
+
+public:
+	virtual ~LogBatchObserver() = default;
+
+	// One map per data point, oldest first, with the same keys as
+	//   LogObserver::onDataPointLogged(..).
+	virtual void onDataPointsLogged(const std::vector<std::map<std::string, std::string>>& data) = 0;
+
+};
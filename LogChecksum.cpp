@@ -0,0 +1,37 @@
+#include <array>
+
+#include "LogChecksum.h"
+
+using namespace std;
+
+
+static array<uint32_t, 256> MakeCrc32Table() {
+	array<uint32_t, 256> table;
+	for (uint32_t i = 0; i < 256; i++) {
+		uint32_t value = i;
+		for (int bit = 0; bit < 8; bit++)
+			value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+		table[i] = value;
+	}
+	return table;
+}
+
+
+uint32_t ComputeLogCrc32(const char* data, size_t size, uint32_t crc) {
+	static const array<uint32_t, 256> table = MakeCrc32Table();
+
+	crc = ~crc;
+	for (size_t i = 0; i < size; i++)
+		crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+string FormatLogCrc32(uint32_t crc) {
+	const char* HEX_DIGITS = "0123456789ABCDEF";
+	string text(8, '0');
+	for (int i = 7; i >= 0; i--) {
+		text[i] = HEX_DIGITS[crc & 0xF];
+		crc >>= 4;
+	}
+	return text;
+}
@@ -0,0 +1,28 @@
+/**
+* Log Checksum : CRC-32 (IEEE 802.3, as used by zip and PNG) for verifying
+*	log files and log records.
+*
+* - Pass the previous result back in as crc to checksum data that arrives
+*		in pieces.
+*
+* Example usage:
+*
+*	std::uint32_t crc = ComputeLogCrc32(first.data(), first.size());
+*	crc = ComputeLogCrc32(second.data(), second.size(), crc);
+*
+*
+* @file LogChecksum.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+std::uint32_t ComputeLogCrc32(const char* data, size_t size, std::uint32_t crc = 0);
+
+// Eight upper-case hex digits, e.g. "CBF43926".
+std::string FormatLogCrc32(std::uint32_t crc);
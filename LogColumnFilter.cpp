@@ -0,0 +1,36 @@
+#include <algorithm>
+
+#include "LogColumnFilter.h"
+
+using namespace std;
+
+
+bool LogColumnFilter::IsEmpty() const {
+	return categories.empty() and prefixes.empty() and columnIds.empty();
+}
+
+bool LogColumnFilter::Matches(const LogColumnInfo& column) const {
+	if (IsEmpty())
+		return true;
+	if (find(columnIds.begin(), columnIds.end(), column.id) != columnIds.end())
+		return true;
+	if (!column.category.empty() and find(categories.begin(), categories.end(), column.category) != categories.end())
+		return true;
+	for (const string& prefix : prefixes) {
+		if (column.name.compare(0, prefix.size(), prefix) == 0)
+			return true;
+	}
+	return false;
+}
+
+shared_ptr<const LogSchema> LogColumnFilter::Project(const shared_ptr<const LogSchema>& schema) const {
+	if (!schema or IsEmpty())
+		return schema;
+
+	vector<LogColumnInfo> columns;
+	for (const LogColumnInfo& column : schema->GetColumns()) {
+		if (Matches(column))
+			columns.push_back(column);
+	}
+	return make_shared<const LogSchema>(move(columns));
+}
@@ -0,0 +1,44 @@
+/**
+* Log Column Filter : Picks the columns an observer subscribes to.
+*
+* - A column matches if its category, a prefix of its name or its id is
+*		listed. An empty filter matches every column.
+* - Project(..) runs once per schema, not once per data point. It returns a
+*		schema with only the matching columns, which keep their ids, so
+*		observers read their values straight from the shared row.
+* - Pass a filter to LogNotifier::addObserver(..), addTypedObserver(..) or
+*		addQueuedObserver(..). CustomLogger::GetCategoryFilter(..) makes one
+*		for a LaserStateLogCategoryEnum.
+*
+* Example usage:
+*
+*	LogColumnFilter filter;
+*	filter.prefixes = { "TecCurrent-", "TecVoltage-" };
+*	logger->addTypedObserver(tecObserver, filter);
+*
+*
+* @file LogColumnFilter.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "LogSchema.h"
+
+
+struct LogColumnFilter {
+	std::vector<std::string> categories;	// E.g. "Temperatures"
+	std::vector<std::string> prefixes;		// E.g. "TecCurrent-"
+	std::vector<size_t> columnIds;			// E.g. LOG_DATE_COLUMN_ID
+
+	bool IsEmpty() const;
+	bool Matches(const LogColumnInfo& column) const;
+
+	// The matching columns of schema, in schema order. Returns schema itself
+	//   if the filter is empty.
+	std::shared_ptr<const LogSchema> Project(const std::shared_ptr<const LogSchema>& schema) const;
+};
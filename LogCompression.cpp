@@ -0,0 +1,214 @@
+#include <cstring>
+#include <vector>
+
+#include "LogCompression.h"
+
+using namespace std;
+
+
+const size_t MIN_MATCH_LENGTH = 4;
+const size_t MAX_MATCH_OFFSET = 65535;
+const int HASH_BITS = 14;
+const unsigned int NIBBLE_MAX = 15;
+
+
+static uint32_t Read32(const char* data) {
+	uint32_t value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+static uint32_t HashOf(uint32_t value) {
+	return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Lengths of 15 or more continue in extra bytes of up to 255 each
+static void AppendLengthExtension(string& out, size_t length) {
+	while (length >= 255) {
+		out += char(255);
+		length -= 255;
+	}
+	out += char(length);
+}
+
+static bool ReadLengthExtension(const unsigned char*& in, const unsigned char* end, size_t& length) {
+	unsigned char byte = 255;
+	while (byte == 255) {
+		if (in >= end)
+			return false;
+		byte = *in++;
+		length += byte;
+	}
+	return true;
+}
+
+// Sequence: token (literal length << 4 | match length - 4), literals,
+// then unless this is the last sequence, u16 match offset
+static void AppendSequence(string& out, const char* literals, size_t literal_length, size_t offset, size_t match_length) {
+	size_t matchCode = match_length >= MIN_MATCH_LENGTH ? match_length - MIN_MATCH_LENGTH : 0;
+	unsigned int token = (unsigned int)(literal_length < NIBBLE_MAX ? literal_length : NIBBLE_MAX) << 4;
+	token |= (unsigned int)(matchCode < NIBBLE_MAX ? matchCode : NIBBLE_MAX);
+	out += char(token);
+
+	if (literal_length >= NIBBLE_MAX)
+		AppendLengthExtension(out, literal_length - NIBBLE_MAX);
+	out.append(literals, literal_length);
+
+	if (match_length == 0)
+		return;
+	out += char(offset & 0xFF);
+	out += char(offset >> 8);
+	if (matchCode >= NIBBLE_MAX)
+		AppendLengthExtension(out, matchCode - NIBBLE_MAX);
+}
+
+
+void CompressLogBlock(const char* data, size_t size, string& out) {
+	out.clear();
+	out.reserve(size / 2 + 16);
+
+	// Positions are stored + 1 so that 0 means empty
+	vector<uint32_t> table(size_t(1) << HASH_BITS, 0);
+	size_t anchor = 0;
+	size_t position = 0;
+
+	while (position + MIN_MATCH_LENGTH <= size) {
+		uint32_t value = Read32(data + position);
+		uint32_t& entry = table[HashOf(value)];
+		size_t candidate = entry;
+		entry = uint32_t(position + 1);
+
+		if (candidate == 0 or position - (candidate - 1) > MAX_MATCH_OFFSET or Read32(data + candidate - 1) != value) {
+			position++;
+			continue;
+		}
+
+		size_t matchStart = candidate - 1;
+		size_t matchLength = MIN_MATCH_LENGTH;
+		while (position + matchLength < size and data[matchStart + matchLength] == data[position + matchLength])
+			matchLength++;
+
+		AppendSequence(out, data + anchor, position - anchor, position - matchStart, matchLength);
+		position += matchLength;
+		anchor = position;
+	}
+
+	AppendSequence(out, data + anchor, size - anchor, 0, 0);
+}
+
+bool DecompressLogBlock(const char* data, size_t size, size_t raw_size, string& out) {
+	out.clear();
+	out.reserve(raw_size);
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+	const unsigned char* end = in + size;
+
+	while (in < end) {
+		unsigned int token = *in++;
+
+		size_t literalLength = token >> 4;
+		if (literalLength == NIBBLE_MAX and !ReadLengthExtension(in, end, literalLength))
+			return false;
+		if (size_t(end - in) < literalLength or out.size() + literalLength > raw_size)
+			return false;
+		out.append(reinterpret_cast<const char*>(in), literalLength);
+		in += literalLength;
+
+		// The last sequence has no match
+		if (in == end)
+			break;
+
+		if (end - in < 2)
+			return false;
+		size_t offset = size_t(in[0]) | (size_t(in[1]) << 8);
+		in += 2;
+		size_t matchLength = token & NIBBLE_MAX;
+		if (matchLength == NIBBLE_MAX and !ReadLengthExtension(in, end, matchLength))
+			return false;
+		matchLength += MIN_MATCH_LENGTH;
+
+		if (offset == 0 or offset > out.size() or out.size() + matchLength > raw_size)
+			return false;
+		// Byte by byte, since a match may overlap the bytes it produces
+		size_t from = out.size() - offset;
+		for (size_t i = 0; i < matchLength; i++)
+			out += out[from + i];
+	}
+
+	return out.size() == raw_size;
+}
+
+
+bool WriteCompressedLogFileHeader(FILE* file) {
+	return fwrite(LOG_COMPRESSED_FILE_MAGIC, 1, sizeof(LOG_COMPRESSED_FILE_MAGIC), file) == sizeof(LOG_COMPRESSED_FILE_MAGIC);
+}
+
+bool WriteCompressedLogBlock(FILE* file, const char* data, size_t size, string& scratch, size_t* stored_bytes) {
+	if (size > LOG_COMPRESSION_BLOCK_SIZE)
+		return false;
+
+	CompressLogBlock(data, size, scratch);
+	bool storeRaw = scratch.size() >= size;
+	uint32_t sizes[2] = { uint32_t(size), uint32_t(storeRaw ? size : scratch.size()) };
+	const char* stored = storeRaw ? data : scratch.data();
+	if (stored_bytes)
+		*stored_bytes = sizeof(sizes) + sizes[1];
+
+	return fwrite(sizes, sizeof(sizes), 1, file) == 1
+		and fwrite(stored, 1, sizes[1], file) == sizes[1];
+}
+
+bool ReadCompressedLogFileHeader(FILE* file) {
+	char magic[sizeof(LOG_COMPRESSED_FILE_MAGIC)];
+	return fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+		and memcmp(magic, LOG_COMPRESSED_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+bool ReadCompressedLogBlock(FILE* file, string& out, string& scratch, bool& corrupt) {
+	corrupt = false;
+	uint32_t sizes[2];
+	size_t read = fread(sizes, 1, sizeof(sizes), file);
+	if (read == 0)
+		return false;
+	if (read != sizeof(sizes) or sizes[0] > LOG_COMPRESSION_BLOCK_SIZE or sizes[1] > sizes[0]) {
+		corrupt = true;
+		return false;
+	}
+
+	scratch.resize(sizes[1]);
+	if (sizes[1] > 0 and fread(&scratch[0], 1, sizes[1], file) != sizes[1]) {
+		corrupt = true;
+		return false;
+	}
+
+	if (sizes[1] == sizes[0]) {
+		out.swap(scratch);
+		return true;
+	}
+	if (!DecompressLogBlock(scratch.data(), scratch.size(), sizes[0], out)) {
+		corrupt = true;
+		return false;
+	}
+	return true;
+}
+
+bool DecompressLogFile(const string& source_path, const string& target_path) {
+	FILE* source = fopen(source_path.c_str(), "rb");
+	if (source == nullptr)
+		return false;
+	FILE* target = fopen(target_path.c_str(), "wb");
+	if (target == nullptr) {
+		fclose(source);
+		return false;
+	}
+
+	bool success = ReadCompressedLogFileHeader(source);
+	string block, scratch;
+	bool corrupt = false;
+	while (success and ReadCompressedLogBlock(source, block, scratch, corrupt))
+		success = fwrite(block.data(), 1, block.size(), target) == block.size();
+	success = success and !corrupt;
+
+	fclose(source);
+	success = fclose(target) == 0 and success;
+	return success;
+}
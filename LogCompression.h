@@ -0,0 +1,60 @@
+/**
+* Log Compression : Small, dependency-free LZ77 block codec for log text,
+*	and the framed file format used for compressed log files.
+*
+* - Blocks are compressed independently, so a compressed file can be written
+*		and read one block at a time, and a torn last block only loses that block.
+* - Log lines repeat a lot (dates, column layouts, similar values), which this
+*		codec exploits with matches of up to 64 KB back. Favors speed over ratio.
+*
+* Compressed file layout:
+*	"LOGLZ001"
+*	per block: u32 raw size, u32 stored size, stored bytes
+*		(stored size == raw size means the block is stored uncompressed)
+*
+* Example usage:
+*
+*	DecompressLogFile("C:/Logs/myLog_0001.log.lz", "C:/Logs/myLog_0001.log");
+*
+*
+* @file LogCompression.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+
+const char LOG_COMPRESSED_FILE_MAGIC[8] = { 'L', 'O', 'G', 'L', 'Z', '0', '0', '1' };
+const char LOG_COMPRESSED_FILE_EXTENSION[] = ".lz";
+const size_t LOG_COMPRESSION_BLOCK_SIZE = 1024 * 1024;
+
+
+// Compress size bytes of data into out (replacing its contents).
+void CompressLogBlock(const char* data, size_t size, std::string& out);
+
+// Decompress a block produced by CompressLogBlock(..) into out (replacing its
+//   contents). Returns false if the block is corrupt or does not decompress to
+//   exactly raw_size bytes.
+bool DecompressLogBlock(const char* data, size_t size, size_t raw_size, std::string& out);
+
+
+// Write the file magic. Call once before writing any block.
+bool WriteCompressedLogFileHeader(std::FILE* file);
+// Compress and write one block of at most LOG_COMPRESSION_BLOCK_SIZE bytes.
+//   scratch is reused between calls to avoid allocations. If stored_bytes is
+//   given, it is set to the bytes the block takes in the file.
+bool WriteCompressedLogBlock(std::FILE* file, const char* data, size_t size, std::string& scratch,
+	size_t* stored_bytes = nullptr);
+
+// Check the file magic. Call once before reading any block.
+bool ReadCompressedLogFileHeader(std::FILE* file);
+// Read and decompress the next block into out. Returns false at the end of the
+//   file, or if the block is torn or corrupt (then corrupt is set to true).
+bool ReadCompressedLogBlock(std::FILE* file, std::string& out, std::string& scratch, bool& corrupt);
+
+// Restore a compressed log file to plain text.
+bool DecompressLogFile(const std::string& source_path, const std::string& target_path);
@@ -0,0 +1,154 @@
+#include "LogDataPointPool.h"
+
+using namespace std;
+
+
+// Free buffers are kept apart from the pool, since released buffers may
+// still need them after the pool itself is gone.
+struct LogDataPointPool::FreeList {
+	mutex lock;
+	vector<LogDataPointRef::Buffer*> buffers;
+	size_t maxBuffers = 0;
+	uint64_t createdCount = 0;
+	bool closed = false;
+};
+
+struct LogDataPointRef::Buffer {
+	LogDataPointEvent event;
+	atomic<uint32_t> references{ 0 };
+	shared_ptr<LogDataPointPool::FreeList> freeList;
+};
+
+
+// ---------------------------------------------------------------------------
+// LogDataPointRef
+
+LogDataPointRef::LogDataPointRef(Buffer* _buffer) : buffer(_buffer) {
+	if (buffer)
+		buffer->references.fetch_add(1, memory_order_relaxed);
+}
+
+LogDataPointRef::LogDataPointRef(const LogDataPointRef& other) : LogDataPointRef(other.buffer) {
+}
+
+LogDataPointRef::LogDataPointRef(LogDataPointRef&& other) noexcept : buffer(other.buffer) {
+	other.buffer = nullptr;
+}
+
+LogDataPointRef& LogDataPointRef::operator=(const LogDataPointRef& other) {
+	if (buffer != other.buffer) {
+		// Taken first, in case releasing this one frees the other
+		if (other.buffer)
+			other.buffer->references.fetch_add(1, memory_order_relaxed);
+		Reset();
+		buffer = other.buffer;
+	}
+	return *this;
+}
+
+LogDataPointRef& LogDataPointRef::operator=(LogDataPointRef&& other) noexcept {
+	if (this != &other) {
+		Reset();
+		buffer = other.buffer;
+		other.buffer = nullptr;
+	}
+	return *this;
+}
+
+LogDataPointRef::~LogDataPointRef() {
+	Reset();
+}
+
+const LogDataPointEvent& LogDataPointRef::operator*() const {
+	return buffer->event;
+}
+
+const LogDataPointEvent* LogDataPointRef::operator->() const {
+	return &buffer->event;
+}
+
+LogDataPointRef::operator bool() const {
+	return buffer != nullptr;
+}
+
+uint32_t LogDataPointRef::GetUseCount() const {
+	return buffer ? buffer->references.load(memory_order_relaxed) : 0;
+}
+
+void LogDataPointRef::Reset() {
+	if (!buffer)
+		return;
+	// acq_rel, so the last holder sees every other holder done with the buffer
+	if (buffer->references.fetch_sub(1, memory_order_acq_rel) == 1)
+		LogDataPointPool::Release(buffer);
+	buffer = nullptr;
+}
+
+
+// ---------------------------------------------------------------------------
+// LogDataPointPool
+
+shared_ptr<LogDataPointPool> LogDataPointPool::Create(size_t max_free_buffers) {
+	return shared_ptr<LogDataPointPool>(new LogDataPointPool(max_free_buffers));
+}
+
+LogDataPointPool::LogDataPointPool(size_t max_free_buffers) : freeList(make_shared<FreeList>()) {
+	freeList->maxBuffers = max_free_buffers;
+	freeList->buffers.reserve(max_free_buffers);
+}
+
+LogDataPointPool::~LogDataPointPool() {
+	vector<LogDataPointRef::Buffer*> buffers;
+	{
+		lock_guard<mutex> lock(freeList->lock);
+		freeList->closed = true;
+		buffers.swap(freeList->buffers);
+	}
+	for (auto buffer : buffers)
+		delete buffer;
+}
+
+size_t LogDataPointPool::GetFreeCount() const {
+	lock_guard<mutex> lock(freeList->lock);
+	return freeList->buffers.size();
+}
+
+uint64_t LogDataPointPool::GetCreatedCount() const {
+	lock_guard<mutex> lock(freeList->lock);
+	return freeList->createdCount;
+}
+
+LogDataPointRef::Buffer* LogDataPointPool::Take() {
+	{
+		lock_guard<mutex> lock(freeList->lock);
+		if (!freeList->buffers.empty()) {
+			LogDataPointRef::Buffer* buffer = freeList->buffers.back();
+			freeList->buffers.pop_back();
+			return buffer;
+		}
+		freeList->createdCount++;
+	}
+	auto buffer = new LogDataPointRef::Buffer();
+	buffer->freeList = freeList;
+	return buffer;
+}
+
+LogDataPointEvent& LogDataPointPool::Contents(LogDataPointRef::Buffer* buffer) {
+	return buffer->event;
+}
+
+void LogDataPointPool::Release(LogDataPointRef::Buffer* buffer) {
+	// Cleared here, on the releasing thread, so the logger gets it back ready to fill
+	buffer->event.schema.reset();
+	buffer->event.values.Clear();
+
+	FreeList& list = *buffer->freeList;
+	{
+		lock_guard<mutex> lock(list.lock);
+		if (!list.closed and list.buffers.size() < list.maxBuffers) {
+			list.buffers.push_back(buffer);
+			return;
+		}
+	}
+	delete buffer;
+}
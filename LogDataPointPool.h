@@ -0,0 +1,124 @@
+/**
+* Log Data Point Pool : Recycles the buffers that typed data points are
+*	published in, so one buffer can be shared by every observer.
+*
+* - The logger fills a buffer once per data point with Make(..), then hands
+*		the same LogDataPointRef to every typed observer. Observers that keep
+*		a data point, e.g. in a QueuedLogObserver, copy the reference, not the
+*		values.
+* - A buffer cannot be changed once Make(..) returns it.
+* - The reference count is intrusive, so publishing a data point does not
+*		allocate. When the last reference is released the buffer goes back to
+*		the pool, keeping the capacity of its values, on whichever thread
+*		released it.
+* - Up to max_free_buffers are kept for reuse; more are deleted. Buffers may
+*		outlive the pool; they are deleted when released.
+*
+* Example usage:
+*
+*	auto pool = LogDataPointPool::Create();
+*	LogDataPointRef dataPoint = pool->Make([&](LogDataPointEvent& event) {
+*		event.schema = schema;
+*		event.values.AddString(date);
+*		...
+*	});
+*	for (auto& observer : observers)
+*		observer->onDataPointLogged(dataPoint);
+*
+*
+* @file LogDataPointPool.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "LogRow.h"
+#include "LogSchema.h"
+
+
+const size_t DEFAULT_DATA_POINT_POOL_SIZE = 256;
+
+
+struct LogDataPointEvent {
+	std::shared_ptr<const LogSchema> schema;	// Schema the values were logged with
+	LogRow values;								// One value per column of schema, indexed by column id
+};
+
+
+class LogDataPointPool;
+
+
+// Shared, read-only reference to a pooled data point. Copying it only
+//   increments a counter; the copies can be released on any thread.
+class LogDataPointRef {
+
+public:
+	LogDataPointRef() = default;
+	LogDataPointRef(const LogDataPointRef& other);
+	LogDataPointRef(LogDataPointRef&& other) noexcept;
+	LogDataPointRef& operator=(const LogDataPointRef& other);
+	LogDataPointRef& operator=(LogDataPointRef&& other) noexcept;
+	~LogDataPointRef();
+
+	const LogDataPointEvent& operator*() const;
+	const LogDataPointEvent* operator->() const;
+	explicit operator bool() const;
+
+	// Number of references to the same buffer, including this one.
+	std::uint32_t GetUseCount() const;
+	void Reset();
+
+
+private:
+	friend class LogDataPointPool;
+	struct Buffer;
+
+	Buffer* buffer = nullptr;
+
+	explicit LogDataPointRef(Buffer* _buffer);
+
+};
+
+
+class LogDataPointPool {
+
+public:
+	static std::shared_ptr<LogDataPointPool> Create(size_t max_free_buffers = DEFAULT_DATA_POINT_POOL_SIZE);
+	~LogDataPointPool();
+
+	LogDataPointPool(const LogDataPointPool&) = delete;
+	LogDataPointPool& operator=(const LogDataPointPool&) = delete;
+
+	// Take a buffer, cleared but with its old capacity, let fill write the data
+	//   point into it, and return the only reference to it.
+	template <typename Fill>
+	LogDataPointRef Make(Fill&& fill) {
+		LogDataPointRef::Buffer* buffer = Take();
+		fill(Contents(buffer));
+		return LogDataPointRef(buffer);
+	}
+
+	size_t GetFreeCount() const;
+	// Buffers created since the pool was, i.e. the times a buffer could not be reused.
+	std::uint64_t GetCreatedCount() const;
+
+
+private:
+	friend class LogDataPointRef;
+	struct FreeList;
+
+	std::shared_ptr<FreeList> freeList;
+
+	explicit LogDataPointPool(size_t max_free_buffers);
+
+	LogDataPointRef::Buffer* Take();
+	static LogDataPointEvent& Contents(LogDataPointRef::Buffer* buffer);
+	static void Release(LogDataPointRef::Buffer* buffer);
+
+};
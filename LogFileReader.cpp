@@ -0,0 +1,397 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include "LogFileReader.h"
+#include "LoggerBase.h"
+#include "LogTimeIndex.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define LOG_READER_USE_SSE2
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+using namespace std;
+
+// Smaller files are not worth splitting across threads
+const size_t MIN_LOG_READER_CHUNK_SIZE = 1024 * 1024;
+
+
+struct LogFileReader::ChunkResult {
+	size_t rows = 0;
+	size_t encryptedLinesSkipped = 0;
+	size_t malformedLines = 0;
+	vector<string> metadataLines;
+};
+
+
+static const string& EncryptedPrefix() {
+	static const string prefix = GetEncryptedLinePrefix();
+	return prefix;
+}
+
+static const string& MetadataPrefix() {
+	static const string prefix = GetMetadataLinePrefix();
+	return prefix;
+}
+
+// Returns end if c is not found
+static const char* FindByte(const char* begin, const char* end, char c) {
+#ifdef LOG_READER_USE_SSE2
+	const __m128i pattern = _mm_set1_epi8(c);
+	while (end - begin >= 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+		unsigned int mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern)));
+		if (mask != 0) {
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return begin + index;
+#else
+			return begin + __builtin_ctz(mask);
+#endif
+		}
+		begin += 16;
+	}
+#endif
+	const void* found = memchr(begin, c, size_t(end - begin));
+	return found != nullptr ? static_cast<const char*>(found) : end;
+}
+
+// Returns the line starting at cursor without its line ending and moves cursor past it
+static string_view NextLine(const char*& cursor, const char* end) {
+	const char* lineEnd = FindByte(cursor, end, '\n');
+	string_view line(cursor, size_t(lineEnd - cursor));
+	cursor = lineEnd < end ? lineEnd + 1 : end;
+	if (!line.empty() and line.back() == '\r')
+		line.remove_suffix(1);
+	return line;
+}
+
+// Loggers end lines and header names with a space
+static string_view Trim(string_view value) {
+	while (!value.empty() and value.front() == ' ')
+		value.remove_prefix(1);
+	while (!value.empty() and (value.back() == ' ' or value.back() == '\r'))
+		value.remove_suffix(1);
+	return value;
+}
+
+static bool StartsWith(string_view line, const string& prefix) {
+	return line.size() >= prefix.size() and line.compare(0, prefix.size(), prefix) == 0;
+}
+
+
+LogFileReader::~LogFileReader() {
+	Close();
+}
+
+bool LogFileReader::Open(const string& file_path, const LogLineDecryptor& decrypt) {
+	Close();
+	decryptor = decrypt;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)) {
+		CloseHandle(file);
+		return false;
+	}
+	fileHandle = file;
+	size = uint64_t(fileSize.QuadPart);
+	if (size > 0) {
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr) {
+			Close();
+			return false;
+		}
+		mappingHandle = mapping;
+		data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		if (data == nullptr) {
+			Close();
+			return false;
+		}
+	}
+#else
+	int file = open(file_path.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+	struct stat fileStatus;
+	if (fstat(file, &fileStatus) != 0) {
+		close(file);
+		return false;
+	}
+	size = uint64_t(fileStatus.st_size);
+	if (size > 0) {
+		void* mapped = mmap(nullptr, size_t(size), PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapped == MAP_FAILED) {
+			close(file);
+			return false;
+		}
+		madvise(mapped, size_t(size), MADV_SEQUENTIAL);
+		data = static_cast<const char*>(mapped);
+	}
+	// The mapping keeps the file alive
+	close(file);
+#endif
+
+	filePath = file_path;
+	isOpen = true;
+	return true;
+}
+
+void LogFileReader::Close() {
+#ifdef _WIN32
+	if (data != nullptr)
+		UnmapViewOfFile(data);
+	if (mappingHandle != nullptr)
+		CloseHandle(mappingHandle);
+	if (fileHandle != nullptr)
+		CloseHandle(fileHandle);
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+#else
+	if (data != nullptr)
+		munmap(const_cast<char*>(data), size_t(size));
+#endif
+	filePath = "";
+	data = nullptr;
+	size = 0;
+	isOpen = false;
+}
+
+bool LogFileReader::IsOpen() const {
+	return isOpen;
+}
+
+void LogFileReader::ForEachLine(const function<bool(string_view, LogLineKind)>& visitor) const {
+	const char* cursor = data;
+	const char* end = data + size;
+	while (cursor < end) {
+		string_view line = NextLine(cursor, end);
+		if (!visitor(line, GetLineKind(line)))
+			return;
+	}
+}
+
+bool LogFileReader::ForEachLineInTimeRange(time_t from_time, time_t to_time,
+	const function<bool(string_view, LogLineKind)>& visitor) const {
+
+	LogTimeIndex index;
+	uint64_t begin = 0;
+	uint64_t end = 0;
+	if (!isOpen or !index.Load(MakeLogTimeIndexPath(filePath)) or !index.FindRange(from_time, to_time, size, begin, end))
+		return false;
+
+	// Indexed offsets are line starts; the last line may run past end
+	const char* cursor = data + begin;
+	const char* rangeEnd = data + end;
+	while (cursor < rangeEnd) {
+		string_view line = NextLine(cursor, data + size);
+		if (!visitor(line, GetLineKind(line)))
+			break;
+	}
+	return true;
+}
+
+bool LogFileReader::ReadTable(LogTable& table, unsigned int thread_count) const {
+	table = LogTable();
+	string_view rawHeader;
+	size_t bodyStart = 0;
+	if (!ReadHeader(rawHeader, table.columnNames, table.metadataLines, bodyStart))
+		return false;
+
+	if (thread_count == 0)
+		thread_count = max(thread::hardware_concurrency(), 1u);
+	size_t bodySize = size_t(size) - bodyStart;
+	unsigned int chunkCount = unsigned(min<size_t>(thread_count, max<size_t>(bodySize / MIN_LOG_READER_CHUNK_SIZE, 1)));
+	vector<size_t> bounds = SplitIntoChunks(bodyStart, chunkCount);
+	vector<ChunkResult> results(chunkCount);
+
+	auto runChunks = [&](const function<void(unsigned int)>& work) {
+		if (chunkCount == 1) {
+			work(0);
+			return;
+		}
+		vector<thread> workers;
+		for (unsigned int chunk = 0; chunk < chunkCount; chunk++)
+			workers.emplace_back(work, chunk);
+		for (thread& worker : workers)
+			worker.join();
+	};
+
+	// First count the rows of every chunk, so each chunk knows where its rows go
+	runChunks([&](unsigned int chunk) {
+		CountRows(bounds[chunk], bounds[chunk + 1], rawHeader, results[chunk]);
+	});
+
+	vector<size_t> firstRows(chunkCount);
+	size_t rowCount = 0;
+	for (unsigned int chunk = 0; chunk < chunkCount; chunk++) {
+		firstRows[chunk] = rowCount;
+		rowCount += results[chunk].rows;
+		table.encryptedLinesSkipped += results[chunk].encryptedLinesSkipped;
+	}
+	table.dates.resize(rowCount);
+	table.times.resize(rowCount);
+	table.columns.assign(table.columnNames.size(), vector<double>(rowCount, nan("")));
+
+	runChunks([&](unsigned int chunk) {
+		ParseRows(bounds[chunk], bounds[chunk + 1], rawHeader, firstRows[chunk], table, results[chunk]);
+	});
+
+	for (ChunkResult& result : results) {
+		table.malformedLines += result.malformedLines;
+		for (string& line : result.metadataLines)
+			table.metadataLines.push_back(move(line));
+	}
+	return true;
+}
+
+LogLineKind LogFileReader::GetLineKind(string_view line) {
+	if (StartsWith(line, MetadataPrefix()))
+		return LogLineKind::METADATA;
+	if (StartsWith(line, EncryptedPrefix()))
+		return LogLineKind::ENCRYPTED;
+	return LogLineKind::DATA;
+}
+
+bool LogFileReader::ReadHeader(string_view& raw_header, vector<string>& column_names,
+	vector<string>& metadata_lines, size_t& body_start) const {
+
+	const char* cursor = data;
+	const char* end = data + size;
+	while (cursor < end) {
+		string_view line = NextLine(cursor, end);
+		LogLineKind kind = GetLineKind(line);
+		if (kind == LogLineKind::METADATA)
+			metadata_lines.emplace_back(line.substr(MetadataPrefix().size()));
+		if (line.empty() or kind == LogLineKind::METADATA)
+			continue;
+
+		string decrypted;
+		string_view header = line;
+		if (kind == LogLineKind::ENCRYPTED) {
+			if (!decryptor)
+				return false;
+			decrypted = decryptor(line.substr(EncryptedPrefix().size()));
+			header = decrypted;
+		}
+
+		// Date and Time are always the first two columns
+		size_t field = 0;
+		const char* position = header.data();
+		const char* headerEnd = header.data() + header.size();
+		while (position <= headerEnd) {
+			const char* comma = FindByte(position, headerEnd, ',');
+			if (field >= 2)
+				column_names.emplace_back(Trim(string_view(position, size_t(comma - position))));
+			field++;
+			position = comma + 1;
+		}
+
+		raw_header = line;
+		body_start = size_t(cursor - data);
+		return true;
+	}
+	return false;
+}
+
+vector<size_t> LogFileReader::SplitIntoChunks(size_t body_start, unsigned int chunk_count) const {
+	vector<size_t> bounds;
+	bounds.push_back(body_start);
+	size_t bodySize = size_t(size) - body_start;
+	for (unsigned int chunk = 1; chunk < chunk_count; chunk++) {
+		// Move each boundary to the start of the next line
+		size_t bound = max(body_start + bodySize / chunk_count * chunk, bounds.back());
+		if (bound > body_start and data[bound - 1] != '\n') {
+			const char* lineEnd = FindByte(data + bound, data + size, '\n');
+			bound = lineEnd < data + size ? size_t(lineEnd - data) + 1 : size_t(size);
+		}
+		bounds.push_back(bound);
+	}
+	bounds.push_back(size_t(size));
+	return bounds;
+}
+
+void LogFileReader::CountRows(size_t begin, size_t end, string_view raw_header, ChunkResult& result) const {
+	const char* cursor = data + begin;
+	const char* chunkEnd = data + end;
+	while (cursor < chunkEnd) {
+		string_view line = NextLine(cursor, chunkEnd);
+		LogLineKind kind = GetLineKind(line);
+		if (line.empty() or kind == LogLineKind::METADATA or line == raw_header)
+			continue;
+		if (kind == LogLineKind::ENCRYPTED and !decryptor)
+			result.encryptedLinesSkipped++;
+		else
+			result.rows++;
+	}
+}
+
+void LogFileReader::ParseRows(size_t begin, size_t end, string_view raw_header, size_t first_row,
+	LogTable& table, ChunkResult& result) const {
+
+	const char* cursor = data + begin;
+	const char* chunkEnd = data + end;
+	size_t row = first_row;
+	size_t columnCount = table.columns.size();
+	string decrypted;
+
+	while (cursor < chunkEnd) {
+		string_view line = NextLine(cursor, chunkEnd);
+		LogLineKind kind = GetLineKind(line);
+		if (kind == LogLineKind::METADATA) {
+			result.metadataLines.emplace_back(line.substr(MetadataPrefix().size()));
+			continue;
+		}
+		if (line.empty() or line == raw_header)
+			continue;
+		if (kind == LogLineKind::ENCRYPTED) {
+			if (!decryptor)
+				continue;
+			decrypted = decryptor(line.substr(EncryptedPrefix().size()));
+			line = decrypted;
+		}
+
+		size_t field = 0;
+		const char* position = line.data();
+		const char* lineEnd = line.data() + line.size();
+		while (position <= lineEnd) {
+			const char* comma = FindByte(position, lineEnd, ',');
+			string_view value = Trim(string_view(position, size_t(comma - position)));
+			if (field == 0)
+				table.dates[row] = string(value);
+			else if (field == 1)
+				table.times[row] = string(value);
+			else if (field - 2 < columnCount) {
+				double number;
+				auto parsed = from_chars(value.data(), value.data() + value.size(), number);
+				if (parsed.ec == errc() and parsed.ptr == value.data() + value.size())
+					table.columns[field - 2][row] = number;
+			}
+			field++;
+			position = comma + 1;
+		}
+		if (field != columnCount + 2)
+			result.malformedLines++;
+		row++;
+	}
+}
@@ -0,0 +1,118 @@
+/**
+* Log File Reader : Loads text log files written by LoggerBase into typed
+*	column buffers.
+*
+* - The file is memory-mapped, not read, and line endings and commas are found
+*		16 bytes at a time with SSE2 where available.
+* - Lines are told apart by their prefix (see GetEncryptedLinePrefix() and
+*		GetMetadataLinePrefix()). Metadata lines are returned separately.
+*		Encrypted lines are only decrypted when they are parsed, with the
+*		decryptor passed to Open(..); without one they are skipped.
+* - The first line that is not a metadata line is the header. Repeated header
+*		lines, e.g. at the top of a rotated segment or an appended session, are
+*		skipped.
+* - With a time index (see LogTimeIndex.h), ForEachLineInTimeRange(..) only
+*		touches the part of the file that holds the requested times.
+* - ReadTable(..) splits the file into one chunk per thread. Each thread
+*		counts its rows, then parses them with std::from_chars straight into
+*		their place in the column buffers.
+*
+* Example usage:
+*
+*	LogFileReader reader;
+*	reader.Open("C:/Users/jbutcher/Documents/myLog1.log");
+*	LogTable table;
+*	if (reader.ReadTable(table))
+*		plot(table.times, table.columns[0]);
+*
+*
+* @file LogFileReader.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// Turns an encrypted line (without its prefix) back into plain text. Must be
+//   safe to call from several threads at once.
+using LogLineDecryptor = std::function<std::string(std::string_view encrypted)>;
+
+
+enum class LogLineKind {
+	DATA,		// Header or data point, in plain text
+	ENCRYPTED,	// Header or data point, encrypted
+	METADATA	// Written with CommitLineMetadata(..)
+};
+
+
+// Contents of a log file, one buffer per column.
+struct LogTable {
+	std::vector<std::string> columnNames;		// Without Date and Time
+	std::vector<std::string> dates;
+	std::vector<std::string> times;
+	std::vector<std::vector<double>> columns;	// One per column name; NaN where a value is missing or not a number
+	std::vector<std::string> metadataLines;		// Without their prefix, in file order
+	size_t encryptedLinesSkipped = 0;			// Encrypted lines found while no decryptor was given
+	size_t malformedLines = 0;					// Data lines with the wrong number of values
+};
+
+
+class LogFileReader {
+
+public:
+	LogFileReader() = default;
+	~LogFileReader();
+
+	LogFileReader(const LogFileReader&) = delete;
+	LogFileReader& operator=(const LogFileReader&) = delete;
+
+	bool Open(const std::string& file_path, const LogLineDecryptor& decrypt = nullptr);
+	void Close();
+	bool IsOpen() const;
+
+	// Call visitor for every line, without its line ending, oldest first.
+	//   Encrypted lines are passed as written. Stops early if the visitor
+	//   returns false.
+	void ForEachLine(const std::function<bool(std::string_view line, LogLineKind kind)>& visitor) const;
+
+	// Same as above, but only for the lines logged from from_time to to_time,
+	//   found with the time index next to the file (see LogTimeIndex.h). Lines
+	//   just outside the range can be included. Returns false if the file has
+	//   no time index.
+	bool ForEachLineInTimeRange(std::time_t from_time, std::time_t to_time,
+		const std::function<bool(std::string_view line, LogLineKind kind)>& visitor) const;
+
+	// Parse the whole file. Returns false if it has no header line.
+	bool ReadTable(LogTable& table, unsigned int thread_count = 0) const;
+
+	static LogLineKind GetLineKind(std::string_view line);
+
+
+private:
+	struct ChunkResult;
+
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+	std::string filePath;
+	const char* data = nullptr;
+	std::uint64_t size = 0;
+	bool isOpen = false;
+	LogLineDecryptor decryptor;
+
+	bool ReadHeader(std::string_view& raw_header, std::vector<std::string>& column_names,
+		std::vector<std::string>& metadata_lines, size_t& body_start) const;
+	std::vector<size_t> SplitIntoChunks(size_t body_start, unsigned int chunk_count) const;
+	void CountRows(size_t begin, size_t end, std::string_view raw_header, ChunkResult& result) const;
+	void ParseRows(size_t begin, size_t end, std::string_view raw_header, size_t first_row,
+		LogTable& table, ChunkResult& result) const;
+
+};
@@ -0,0 +1,255 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+#include "LogHistory.h"
+
+using namespace std;
+
+
+static string MakeSpillFilePath() {
+	static atomic<unsigned int> spillFileCounter{ 0 };
+	auto ticks = chrono::steady_clock::now().time_since_epoch().count();
+	string fileName = "LogHistory_" + to_string(ticks) + "_" + to_string(spillFileCounter++) + ".tmp";
+	return (filesystem::temp_directory_path() / fileName).string();
+}
+
+
+LogHistory::SpillFile::~SpillFile() {
+	if (file != nullptr)
+		fclose(file);
+	if (deleteWhenDone) {
+		error_code ignored;
+		filesystem::remove(path, ignored);
+	}
+}
+
+
+LogHistory::LogHistory() {
+	activeSegment.reserve(LOG_HISTORY_SEGMENT_LINES);
+}
+
+LogHistory::~LogHistory() {
+	Clear();
+}
+
+void LogHistory::Append(const string& line) {
+	lock_guard<mutex> lock(historyMutex);
+	size_t bytes = LineBytes(line);
+	activeSegment.push_back(line);
+	activeSegmentBytes += bytes;
+	bytesInMemory += bytes;
+	linesInMemory++;
+
+	if (activeSegment.size() >= LOG_HISTORY_SEGMENT_LINES)
+		SealActiveSegment();
+	if (OverLimit())
+		SpillWhileOverLimit();
+}
+
+void LogHistory::Clear() {
+	lock_guard<mutex> lock(historyMutex);
+	sealedSegments.clear();
+	activeSegment.clear();
+	activeSegmentBytes = 0;
+	bytesInMemory = 0;
+	linesInMemory = 0;
+	journalFile.reset();
+	spillFile.reset();
+	spillFailed = false;
+}
+
+size_t LogHistory::GetLineCount() const {
+	lock_guard<mutex> lock(historyMutex);
+	return (journalFile ? journalFile->lineCount : 0) + linesInMemory + (spillFile ? spillFile->lineCount : 0);
+}
+
+size_t LogHistory::GetBytesInMemory() const {
+	lock_guard<mutex> lock(historyMutex);
+	return bytesInMemory;
+}
+
+size_t LogHistory::GetSpilledLineCount() const {
+	lock_guard<mutex> lock(historyMutex);
+	return spillFile ? spillFile->lineCount : 0;
+}
+
+void LogHistory::SetMemoryLimit(size_t max_bytes, size_t max_lines) {
+	lock_guard<mutex> lock(historyMutex);
+	maxBytesInMemory = max_bytes;
+	maxLinesInMemory = max_lines;
+	if (OverLimit())
+		SpillWhileOverLimit();
+}
+
+void LogHistory::SetSpillEnabled(bool enabled) {
+	lock_guard<mutex> lock(historyMutex);
+	spillEnabled = enabled;
+	if (OverLimit())
+		SpillWhileOverLimit();
+}
+
+bool LogHistory::ForEachLine(const function<bool(const string&)>& visitor) const {
+	return TakeSnapshot().ForEachLine(visitor);
+}
+
+LogHistory::Snapshot LogHistory::TakeSnapshot() const {
+	lock_guard<mutex> lock(historyMutex);
+
+	Snapshot snapshot;
+	if (journalFile) {
+		snapshot.journalFile = journalFile;
+		snapshot.journalLines = journalFile->lineCount;
+	}
+	if (spillFile) {
+		// Lines spilled later are appended after these, so the first spilledLines records stay valid
+		fflush(spillFile->file);
+		snapshot.spillFile = spillFile;
+		snapshot.spilledLines = spillFile->lineCount;
+	}
+	snapshot.sealedSegments.reserve(sealedSegments.size());
+	for (auto& segment : sealedSegments)
+		snapshot.sealedSegments.push_back(segment.lines);
+	snapshot.activeLines = activeSegment;
+	return snapshot;
+}
+
+void LogHistory::RestoreFromJournal(const string& journal_path, const LogJournalRecovery& recovery) {
+	lock_guard<mutex> lock(historyMutex);
+	if (recovery.records == 0) {
+		journalFile.reset();
+		return;
+	}
+
+	auto restored = make_shared<SpillFile>();
+	restored->path = journal_path;
+	restored->lineCount = recovery.records;
+	restored->firstRecordOffset = LOG_JOURNAL_HEADER_SIZE;
+	restored->recordHeaderBytes = LOG_JOURNAL_RECORD_HEADER_SIZE;
+	restored->deleteWhenDone = false;
+	journalFile = restored;
+}
+
+
+size_t LogHistory::Snapshot::GetLineCount() const {
+	size_t lineCount = journalLines + spilledLines + activeLines.size();
+	for (auto& segment : sealedSegments)
+		lineCount += segment->size();
+	return lineCount;
+}
+
+bool LogHistory::Snapshot::ForEachLine(const function<bool(const string&)>& visitor) const {
+	if (journalFile and !ReadLines(*journalFile, journalLines, visitor))
+		return false;
+	if (spillFile and !ReadLines(*spillFile, spilledLines, visitor))
+		return false;
+
+	for (auto& segment : sealedSegments) {
+		for (const string& line : *segment) {
+			if (!visitor(line))
+				return false;
+		}
+	}
+	for (const string& line : activeLines) {
+		if (!visitor(line))
+			return false;
+	}
+	return true;
+}
+
+void LogHistory::SealActiveSegment() {
+	if (activeSegment.empty())
+		return;
+
+	Segment segment;
+	segment.lines = make_shared<const vector<string>>(move(activeSegment));
+	segment.bytes = activeSegmentBytes;
+	sealedSegments.push_back(segment);
+
+	activeSegment = vector<string>();
+	activeSegment.reserve(LOG_HISTORY_SEGMENT_LINES);
+	activeSegmentBytes = 0;
+}
+
+void LogHistory::SpillWhileOverLimit() {
+	// Only sealed segments are spilled, so the newest lines always stay in memory
+	while (spillEnabled and OverLimit() and !sealedSegments.empty() and !spillFailed) {
+		Segment& oldest = sealedSegments.front();
+		if (!SpillSegment(oldest)) {
+			spillFailed = true;
+			return;
+		}
+		bytesInMemory -= oldest.bytes;
+		linesInMemory -= oldest.lines->size();
+		sealedSegments.pop_front();
+	}
+}
+
+bool LogHistory::SpillSegment(const Segment& segment) {
+	if (!spillFile) {
+		auto newSpillFile = make_shared<SpillFile>();
+		newSpillFile->path = MakeSpillFilePath();
+		newSpillFile->file = fopen(newSpillFile->path.c_str(), "wb");
+		if (newSpillFile->file == nullptr)
+			return false;
+		spillFile = newSpillFile;
+	}
+
+	for (const string& line : *segment.lines) {
+		uint32_t length = uint32_t(line.size());
+		if (fwrite(&length, sizeof(length), 1, spillFile->file) != 1
+			or fwrite(line.data(), 1, line.size(), spillFile->file) != line.size())
+			return false;
+	}
+	spillFile->lineCount += segment.lines->size();
+	return true;
+}
+
+bool LogHistory::OverLimit() const {
+	if (maxBytesInMemory > 0 and bytesInMemory > maxBytesInMemory)
+		return true;
+	return maxLinesInMemory > 0 and linesInMemory > maxLinesInMemory;
+}
+
+size_t LogHistory::LineBytes(const string& line) {
+	return sizeof(string) + line.size();
+}
+
+bool LogHistory::ReadLines(const SpillFile& source, size_t line_count, const function<bool(const string&)>& visitor) {
+	FILE* reader = fopen(source.path.c_str(), "rb");
+	if (reader == nullptr)
+		return false;
+#ifdef _WIN32
+	bool positioned = _fseeki64(reader, int64_t(source.firstRecordOffset), SEEK_SET) == 0;
+#else
+	bool positioned = fseeko(reader, off_t(source.firstRecordOffset), SEEK_SET) == 0;
+#endif
+	if (!positioned) {
+		fclose(reader);
+		return false;
+	}
+
+	// Only the length is needed; a journal's checksum was verified when it was recovered
+	char header[LOG_JOURNAL_RECORD_HEADER_SIZE];
+	string line;
+	for (size_t i = 0; i < line_count; i++) {
+		uint32_t length = 0;
+		if (fread(header, 1, source.recordHeaderBytes, reader) != source.recordHeaderBytes) {
+			fclose(reader);
+			return false;
+		}
+		memcpy(&length, header, sizeof(length));
+		line.resize(length);
+		if (length > 0 and fread(&line[0], 1, length, reader) != length) {
+			fclose(reader);
+			return false;
+		}
+		if (!visitor(line)) {
+			fclose(reader);
+			return false;
+		}
+	}
+	fclose(reader);
+	return true;
+}
@@ -0,0 +1,145 @@
+/**
+* Log History : In-memory copy of every line a logger has committed, with a
+*	cap on how much of it stays in memory.
+*
+* - Lines are stored in fixed-size segments. Once a segment is full it is sealed
+*		and never modified again.
+* - When the lines held in memory exceed the byte or line limit, the oldest
+*		sealed segments are spilled to a temporary segment file and dropped from
+*		memory. ForEachLine(..) stitches spilled and in-memory lines back together
+*		in their original order.
+* - The temporary file is deleted by Clear() and on destruction, or once the
+*		last snapshot using it is gone.
+* - Lines are spilled exactly as appended. SetSpillEnabled(false) keeps every
+*		line in memory instead, for lines that must never be written to disk
+*		in the clear.
+* - TakeSnapshot() captures the current lines without copying them: sealed
+*		segments and the spill file are shared, only the active segment (at most
+*		LOG_HISTORY_SEGMENT_LINES lines) is copied. The snapshot can then be read
+*		on any thread while new lines keep being appended.
+* - RestoreFromJournal(..) takes over the lines of a crash journal (see
+*		LogJournal.h) as the oldest lines, reading them from the journal file
+*		only when they are visited.
+* - All methods are thread-safe.
+*
+*
+* @file LogHistory.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "LogJournal.h"
+
+
+const size_t DEFAULT_LOG_HISTORY_MEMORY_LIMIT_IN_BYTES = 64 * 1024 * 1024;
+const size_t LOG_HISTORY_SEGMENT_LINES = 1024;
+
+
+class LogHistory {
+
+	struct SpillFile;
+
+public:
+	// Read-only view of the lines at the time it was taken.
+	class Snapshot {
+	public:
+		size_t GetLineCount() const;
+		// Call visitor for every line, oldest first. Stops early and returns
+		//   false if the visitor returns false or spilled lines cannot be read back.
+		bool ForEachLine(const std::function<bool(const std::string&)>& visitor) const;
+
+	private:
+		friend class LogHistory;
+		std::shared_ptr<SpillFile> journalFile;
+		size_t journalLines = 0;
+		std::shared_ptr<SpillFile> spillFile;
+		size_t spilledLines = 0;
+		std::vector<std::shared_ptr<const std::vector<std::string>>> sealedSegments;
+		std::vector<std::string> activeLines;
+	};
+
+	LogHistory();
+	~LogHistory();
+
+	LogHistory(const LogHistory&) = delete;
+	LogHistory& operator=(const LogHistory&) = delete;
+
+	void Append(const std::string& line);
+	void Clear();
+
+	// Total lines, including spilled lines.
+	size_t GetLineCount() const;
+	// Approximate bytes of lines currently held in memory.
+	size_t GetBytesInMemory() const;
+	// Lines currently stored in the temporary segment file.
+	size_t GetSpilledLineCount() const;
+
+	// Keep at most max_bytes and max_lines in memory. 0 means no limit.
+	void SetMemoryLimit(size_t max_bytes, size_t max_lines);
+	// While disabled, the memory limit is ignored and no more lines are spilled.
+	//   Lines spilled before are kept.
+	void SetSpillEnabled(bool enabled);
+
+	// Call visitor for every line, oldest first. Stops early and returns false
+	//   if the visitor returns false or spilled lines cannot be read back.
+	//   Works on a snapshot, so lines can be appended while it runs.
+	bool ForEachLine(const std::function<bool(const std::string&)>& visitor) const;
+
+	Snapshot TakeSnapshot() const;
+
+	// Use the intact records of the journal at journal_path, as found by
+	//   RecoverLogJournal(..), as the oldest lines. The records are not read
+	//   now, and the journal file is never modified or deleted by the history.
+	void RestoreFromJournal(const std::string& journal_path, const LogJournalRecovery& recovery);
+
+
+private:
+	struct Segment {
+		std::shared_ptr<const std::vector<std::string>> lines;
+		size_t bytes = 0;
+	};
+
+	// File of length-prefixed lines: the temporary spill file (deleted when
+	//   destroyed) or a restored journal (kept).
+	struct SpillFile {
+		std::string path;
+		std::FILE* file = nullptr;
+		size_t lineCount = 0;
+		std::uint64_t firstRecordOffset = 0;
+		size_t recordHeaderBytes = sizeof(std::uint32_t);
+		bool deleteWhenDone = true;
+		~SpillFile();
+	};
+
+	mutable std::mutex historyMutex;
+	std::deque<Segment> sealedSegments;
+	std::vector<std::string> activeSegment;
+	size_t activeSegmentBytes = 0;
+	size_t bytesInMemory = 0;
+	size_t linesInMemory = 0;
+	size_t maxBytesInMemory = DEFAULT_LOG_HISTORY_MEMORY_LIMIT_IN_BYTES;
+	size_t maxLinesInMemory = 0;
+	std::shared_ptr<SpillFile> journalFile;
+	std::shared_ptr<SpillFile> spillFile;
+	bool spillFailed = false;
+	bool spillEnabled = true;
+
+	void SealActiveSegment();
+	void SpillWhileOverLimit();
+	bool SpillSegment(const Segment& segment);
+	bool OverLimit() const;
+	static size_t LineBytes(const std::string& line);
+	static bool ReadLines(const SpillFile& source, size_t line_count,
+		const std::function<bool(const std::string&)>& visitor);
+
+};
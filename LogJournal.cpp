@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#include "LogJournal.h"
+#include "LogChecksum.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+
+const char LOG_JOURNAL_MAGIC[8] = { 'L', 'O', 'G', 'J', 'R', 'N', 'L', '1' };
+const char CLOSED_LOG_JOURNAL_MAGIC[8] = { 'L', 'O', 'G', 'J', 'R', 'N', 'L', 'C' };
+const uint32_t MAX_LOG_JOURNAL_RECORD_SIZE = 64 * 1024 * 1024;
+const size_t TORN_LINE_SEARCH_BLOCK_SIZE = 64 * 1024;
+
+
+static bool SeekTo(FILE* file, uint64_t offset) {
+#ifdef _WIN32
+	return _fseeki64(file, int64_t(offset), SEEK_SET) == 0;
+#else
+	return fseeko(file, off_t(offset), SEEK_SET) == 0;
+#endif
+}
+
+static void AppendRecord(string& out, const string& line) {
+	uint32_t header[2] = { uint32_t(line.size()), ComputeLogCrc32(line.data(), line.size()) };
+	out.append(reinterpret_cast<const char*>(header), sizeof(header));
+	out += line;
+}
+
+
+bool RecoverLogJournal(const string& file_path, LogJournalRecovery& recovery) {
+	recovery = LogJournalRecovery();
+	error_code sizeError;
+	uint64_t fileSize = filesystem::file_size(file_path, sizeError);
+	if (sizeError)
+		return false;
+
+	FILE* file = fopen(file_path.c_str(), "rb");
+	if (file == nullptr)
+		return false;
+
+	char magic[sizeof(LOG_JOURNAL_MAGIC)];
+	uint64_t checkpoint[2] = { 0, 0 };
+	if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) or fread(checkpoint, sizeof(checkpoint), 1, file) != 1) {
+		fclose(file);
+		return false;
+	}
+	if (memcmp(magic, CLOSED_LOG_JOURNAL_MAGIC, sizeof(magic)) == 0) {
+		fclose(file);
+		recovery.closedCleanly = true;
+		return true;
+	}
+	if (memcmp(magic, LOG_JOURNAL_MAGIC, sizeof(magic)) != 0) {
+		fclose(file);
+		return false;
+	}
+
+	// A checkpoint that points past the data cannot be trusted; verify everything instead
+	if (checkpoint[0] >= LOG_JOURNAL_HEADER_SIZE and checkpoint[0] <= fileSize) {
+		recovery.dataEnd = checkpoint[0];
+		recovery.records = size_t(checkpoint[1]);
+	}
+
+	string line;
+	bool intact = SeekTo(file, recovery.dataEnd);
+	while (intact) {
+		uint32_t header[2];
+		size_t read = fread(header, 1, sizeof(header), file);
+		if (read == 0)
+			break;
+		if (read != sizeof(header) or header[0] > MAX_LOG_JOURNAL_RECORD_SIZE) {
+			intact = false;
+			break;
+		}
+		line.resize(header[0]);
+		if ((header[0] > 0 and fread(&line[0], 1, header[0], file) != header[0])
+			or ComputeLogCrc32(line.data(), line.size()) != header[1]) {
+			intact = false;
+			break;
+		}
+		recovery.dataEnd += sizeof(header) + header[0];
+		recovery.records++;
+		recovery.verifiedRecords++;
+	}
+	fclose(file);
+
+	if (recovery.dataEnd < fileSize) {
+		error_code resizeError;
+		filesystem::resize_file(file_path, recovery.dataEnd, resizeError);
+		if (resizeError)
+			return false;
+		recovery.truncated = true;
+	}
+	return true;
+}
+
+bool TrimTornLogLine(const string& file_path) {
+	error_code sizeError;
+	uint64_t fileSize = filesystem::file_size(file_path, sizeError);
+	if (sizeError)
+		return false;
+	if (fileSize == 0)
+		return true;
+
+	FILE* file = fopen(file_path.c_str(), "rb");
+	if (file == nullptr)
+		return false;
+
+	// Search backwards for the last line ending
+	string block(TORN_LINE_SEARCH_BLOCK_SIZE, '\0');
+	uint64_t end = fileSize;
+	uint64_t keep = 0;
+	bool found = false;
+	bool readFailed = false;
+	while (end > 0 and !found) {
+		uint64_t start = end > block.size() ? end - block.size() : 0;
+		size_t size = size_t(end - start);
+		if (!SeekTo(file, start) or fread(&block[0], 1, size, file) != size) {
+			readFailed = true;
+			break;
+		}
+		for (size_t i = size; i > 0; i--) {
+			if (block[i - 1] == '\n') {
+				keep = start + i;
+				found = true;
+				break;
+			}
+		}
+		// The last line is complete
+		if (found and keep == fileSize)
+			break;
+		end = start;
+	}
+	fclose(file);
+
+	if (readFailed)
+		return false;
+	if (keep == fileSize)
+		return true;
+
+	error_code resizeError;
+	filesystem::resize_file(file_path, keep, resizeError);
+	return !resizeError;
+}
+
+LogOutputPolicy GetDefaultLogJournalPolicy() {
+	LogOutputPolicy policy;
+	policy.maxBufferedBytes = 0;
+	policy.durabilityMode = LogDurabilityMode::GROUP_COMMIT;
+	return policy;
+}
+
+
+LogJournal::~LogJournal() {
+	Close();
+}
+
+bool LogJournal::CloseCleanly() {
+	if (!IsFileOpen())
+		return false;
+	closingCleanly = true;
+	closedCleanly = false;
+	Close();
+	closingCleanly = false;
+	return closedCleanly;
+}
+
+bool LogJournal::Flush() {
+	if (file == nullptr)
+		return false;
+	if (buffer.empty())
+		return true;
+
+	bool success = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+	if (success) {
+		writtenOffset += buffer.size();
+		writtenRecords += pendingRecords;
+	}
+	buffer.clear();
+	pendingRecords = 0;
+	return success;
+}
+
+const LogJournalRecovery& LogJournal::GetRecovery() const {
+	return recovery;
+}
+
+bool LogJournal::OpenFile(const string& file_path) {
+	error_code sizeError;
+	uint64_t existingBytes = filesystem::file_size(file_path, sizeError);
+	bool newJournal = sizeError or existingBytes == 0;
+	if (!newJournal) {
+		if (!RecoverLogJournal(file_path, recovery))
+			return false;
+		// The last session ended normally; start over instead of growing the file
+		newJournal = recovery.closedCleanly;
+	}
+
+	if (newJournal) {
+		recovery = LogJournalRecovery();
+		file = fopen(file_path.c_str(), "w+b");
+		if (file == nullptr)
+			return false;
+		setvbuf(file, nullptr, _IONBF, 0);
+		if (!WriteCheckpoint(LOG_JOURNAL_HEADER_SIZE, 0)) {
+			CloseFile();
+			return false;
+		}
+	}
+	else {
+		file = fopen(file_path.c_str(), "r+b");
+		if (file == nullptr)
+			return false;
+		setvbuf(file, nullptr, _IONBF, 0);
+	}
+
+	writtenOffset = recovery.dataEnd;
+	writtenRecords = recovery.records;
+	if (!SeekTo(file, writtenOffset)) {
+		CloseFile();
+		return false;
+	}
+	return true;
+}
+
+void LogJournal::CloseFile() {
+	// Close() has already committed the records
+	if (closingCleanly)
+		closedCleanly = Flush() and WriteCheckpoint(writtenOffset, writtenRecords, true);
+	fclose(file);
+	file = nullptr;
+}
+
+bool LogJournal::IsFileOpen() const {
+	return file != nullptr;
+}
+
+bool LogJournal::AppendPending(const string& text) {
+	AppendRecord(buffer, text);
+	pendingRecords++;
+	return true;
+}
+
+size_t LogJournal::GetPendingBytes() const {
+	return buffer.size();
+}
+
+bool LogJournal::SyncToDisk() {
+#ifdef _WIN32
+	bool synced = _commit(_fileno(file)) == 0;
+#else
+	bool synced = fdatasync(fileno(file)) == 0;
+#endif
+	// The checkpoint itself reaches the disk with the next sync; until then the previous one stays valid
+	return synced and WriteCheckpoint(writtenOffset, writtenRecords) and SeekTo(file, writtenOffset);
+}
+
+bool LogJournal::WriteCheckpoint(uint64_t offset, uint64_t records, bool closed) {
+	uint64_t checkpoint[2] = { offset, records };
+	const char* magic = closed ? CLOSED_LOG_JOURNAL_MAGIC : LOG_JOURNAL_MAGIC;
+	return SeekTo(file, 0)
+		and fwrite(magic, 1, sizeof(LOG_JOURNAL_MAGIC), file) == sizeof(LOG_JOURNAL_MAGIC)
+		and fwrite(checkpoint, sizeof(checkpoint), 1, file) == 1;
+}
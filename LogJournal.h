@@ -0,0 +1,103 @@
+/**
+* Log Journal : Crash-safe, checksummed journal of every line a logger
+*	commits, used to restore the in-memory log after a crash.
+*
+* - A LogOutputFile backend, so the usual flush and durability policies apply.
+*		By default every record is handed to the operating system immediately
+*		(survives an application crash) and records are synced in groups
+*		(GROUP_COMMIT, survives a power loss up to the last group).
+* - Every record carries its length and the CRC-32 of the line.
+* - After every sync, the header is updated with a checkpoint: the offset and
+*		number of records known to be on disk. Recovery trusts everything before
+*		the checkpoint and only verifies the records after it, so recovering a
+*		large journal only reads its tail. The first torn or corrupt record and
+*		everything after it are cut off.
+* - CloseCleanly() marks the journal as closed after a normal shutdown. Its
+*		records stay readable, but recovery reports none and the next Open(..)
+*		starts the journal over, so only a crash leaves records to restore.
+* - Lines are stored in plain text, so loggers that encrypt their lines do
+*		not journal them.
+*
+* Journal file layout:
+*	"LOGJRNL1" ("LOGJRNLC" once closed cleanly), u64 checkpoint offset,
+*		u64 checkpoint record count
+*	per record: u32 line length, u32 CRC-32 of the line, line bytes
+*
+*
+* @file LogJournal.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "LogOutputFile.h"
+
+
+const std::uint64_t LOG_JOURNAL_HEADER_SIZE = 24;
+const size_t LOG_JOURNAL_RECORD_HEADER_SIZE = 8;
+
+
+// Where the intact records of a journal end, found by RecoverLogJournal(..).
+struct LogJournalRecovery {
+	std::uint64_t dataEnd = LOG_JOURNAL_HEADER_SIZE;	// Offset just past the last intact record
+	size_t records = 0;									// Intact records
+	size_t verifiedRecords = 0;							// Records checked because they follow the checkpoint
+	bool truncated = false;								// A torn or corrupt tail was cut off
+	bool closedCleanly = false;							// The last session ended normally; nothing to restore
+};
+
+// Find the intact records of the journal at file_path and cut off anything
+//   after them. Returns false if the file is missing or is not a journal.
+bool RecoverLogJournal(const std::string& file_path, LogJournalRecovery& recovery);
+
+// Cut off a partially written last line of a text log file, e.g. after a crash.
+//   Only the end of the file is read. Returns false if the file could not be
+//   read or truncated.
+bool TrimTornLogLine(const std::string& file_path);
+
+// Flush every record immediately, sync in groups.
+LogOutputPolicy GetDefaultLogJournalPolicy();
+
+
+class LogJournal : public LogOutputFile {
+
+public:
+	LogJournal() = default;
+	~LogJournal();
+
+	bool Flush() override;
+	// Close after a normal shutdown, see above. Returns false if the journal
+	//   was not open or could not be marked as closed.
+	bool CloseCleanly();
+
+	// Results of recovering the journal when it was opened.
+	const LogJournalRecovery& GetRecovery() const;
+
+
+protected:
+	bool OpenFile(const std::string& file_path) override;
+	void CloseFile() override;
+	bool IsFileOpen() const override;
+	bool AppendPending(const std::string& text) override;
+	size_t GetPendingBytes() const override;
+	// Syncs the records, then moves the checkpoint past them.
+	bool SyncToDisk() override;
+
+
+private:
+	std::FILE* file = nullptr;
+	std::string buffer;
+	size_t pendingRecords = 0;
+	std::uint64_t writtenOffset = LOG_JOURNAL_HEADER_SIZE;
+	size_t writtenRecords = 0;
+	LogJournalRecovery recovery;
+	bool closingCleanly = false;
+	bool closedCleanly = false;
+
+	bool WriteCheckpoint(std::uint64_t offset, std::uint64_t records, bool closed = false);
+
+};
@@ -3,34 +3,234 @@
 
 #pragma once
 
+#include <algorithm>
+#include <functional>
 #include <map>
 #include <memory>
-#include <set>
 #include <string>
+#include <vector>
 
+#include "CopyOnWriteLogValue.h"
+#include "LogBatchObserver.h"
+#include "LogColumnFilter.h"
 #include "LogObserver.h"
+#include "QueuedLogObserver.h"
+#include "TypedLogObserver.h"
 
 
+// Observers can be added and removed from any thread while data points are
+// being logged. The logging thread notifies a snapshot of the observer lists
+// without locking (see CopyOnWriteLogValue.h), so an observer can still be
+// called once or twice just after it was removed. Observers are therefore
+// shared: the lists keep a removed observer alive until the last
+// notification using them has finished, which then releases it.
 class LogNotifier {
 //Adding Observers
 public:
+	// Deprecated: the lists do not own observer, so they cannot keep it alive
+	//   while a notification is still using it after removeObserver(..). The
+	//   caller must keep it alive for as long as the logger. Prefer shared_ptr.
+	[[deprecated("Register observers as std::shared_ptr")]]
 	void addObserver(LogObserver* observer) {
-		logObservers_p.insert(observer);
+		addObserver(std::shared_ptr<LogObserver>(observer, [](LogObserver*) {}));
 	};
 	void addObserver(std::shared_ptr<LogObserver> observer) {
-		logObservers_sp.insert(observer);
+		observers.Update([&](ObserverLists& lists) {
+			if (std::find(lists.observers.begin(), lists.observers.end(), observer) == lists.observers.end())
+				lists.observers.push_back(observer);
+		});
+	};
+	// Only receive the columns that match filter (see LogColumnFilter.h). The
+	//   map holds just those columns, found once per header line.
+	void addObserver(std::shared_ptr<LogObserver> observer, const LogColumnFilter& filter) {
+		if (filter.IsEmpty()) {
+			addObserver(std::move(observer));
+			return;
+		}
+		observers.Update([&](ObserverLists& lists) {
+			removeFrom(lists.filteredObservers, observer.get());
+			lists.filteredObservers.push_back({ observer, filter, filter.Project(lists.schema) });
+		});
+	};
+	// Call observer from the thread of the caller's choosing instead of the
+	//   logging thread (see QueuedLogObserver.h). schedule_drain runs on the
+	//   logging thread once per burst of data points and must arrange for
+	//   Drain() of the queue it is given to be called, e.g. with CallAfter(..).
+	std::shared_ptr<QueuedLogObserver> addQueuedObserver(std::shared_ptr<LogObserver> observer,
+		std::function<void(std::shared_ptr<QueuedLogObserver>)> schedule_drain,
+		LogDispatchCoalescing coalescing = LogDispatchCoalescing::NONE,
+		const LogColumnFilter& filter = LogColumnFilter()) {
+		auto queued = std::make_shared<QueuedLogObserver>(std::move(observer), coalescing);
+		setDrainScheduler(queued, std::move(schedule_drain));
+		addObserver(queued, filter);
+		return queued;
+	};
+	// Receive data points as typed values by column id (see TypedLogObserver.h).
+	//   With a filter, the observer is sent a schema with only the matching columns.
+	//   The observer must not add or remove observers from onSchemaPublished(..).
+	void addTypedObserver(std::shared_ptr<TypedLogObserver> observer, const LogColumnFilter& filter = LogColumnFilter()) {
+		observers.Update([&](ObserverLists& lists) {
+			// Sent while no other schema can be published, so it cannot arrive out of order
+			if (lists.schema)
+				observer->onSchemaPublished(filter.Project(lists.schema));
+			removeFrom(lists.typedObservers, observer.get());
+			lists.typedObservers.push_back({ observer, filter });
+		});
+	};
+	std::shared_ptr<QueuedLogObserver> addQueuedObserver(std::shared_ptr<TypedLogObserver> observer,
+		std::function<void(std::shared_ptr<QueuedLogObserver>)> schedule_drain,
+		LogDispatchCoalescing coalescing = LogDispatchCoalescing::NONE,
+		const LogColumnFilter& filter = LogColumnFilter()) {
+		auto queued = std::make_shared<QueuedLogObserver>(std::move(observer), coalescing);
+		// Projected by the queue, when it delivers the schema on the observer's thread
+		queued->SetColumnFilter(filter);
+		setDrainScheduler(queued, std::move(schedule_drain));
+		addTypedObserver(queued);
+		return queued;
+	};
+
+//Removing Observers
+	// Never waits for the logging thread; see the note above the class.
+	void removeObserver(const std::shared_ptr<LogObserver>& observer) {
+		removeObserver(observer.get());
+	};
+	void removeObserver(LogObserver* observer) {
+		observers.Update([&](ObserverLists& lists) {
+			removeFrom(lists.observers, observer);
+			removeFrom(lists.filteredObservers, observer);
+		});
+	};
+	void removeTypedObserver(const std::shared_ptr<TypedLogObserver>& observer) {
+		observers.Update([&](ObserverLists& lists) {
+			removeFrom(lists.typedObservers, observer.get());
+		});
+	};
+	// Data points already queued stay queued; call Close() on the queue from
+	//   its drain thread to drop them and release the wrapped observer.
+	void removeQueuedObserver(const std::shared_ptr<QueuedLogObserver>& queued) {
+		observers.Update([&](ObserverLists& lists) {
+			removeFrom(lists.observers, static_cast<LogObserver*>(queued.get()));
+			removeFrom(lists.filteredObservers, static_cast<LogObserver*>(queued.get()));
+			removeFrom(lists.typedObservers, static_cast<TypedLogObserver*>(queued.get()));
+		});
 	};
 
 
 protected:
-	std::set<std::shared_ptr<LogObserver>> logObservers_sp;
-	std::set<LogObserver*> logObservers_p;
+	// Only used by the logging thread
+	std::shared_ptr<const LogSchema> publishedSchema;
+
+	bool hasObservers() const {
+		return !observers.Read()->observers.empty();
+	};
+	bool hasFilteredObservers() const {
+		return !observers.Read()->filteredObservers.empty();
+	};
+	bool hasTypedObservers() const {
+		return !observers.Read()->typedObservers.empty();
+	};
 	//Notifying Observers
 	void dataPointLogged(std::map<std::string, std::string> data) {
-		for (auto& observer : logObservers_p)
-			observer->onDataPointLogged(data);
-		for (auto& observer : logObservers_sp)
+		auto lists = observers.Read();
+		for (auto& observer : lists->observers)
 			observer->onDataPointLogged(data);
 	};
+	void dataPointsLogged(const std::vector<std::map<std::string, std::string>>& data) {
+		auto lists = observers.Read();
+		for (auto& observer : lists->observers)
+			notifyBatch(observer.get(), data);
+	};
+	// make_data(columns) returns the map for one filtered observer, with only
+	//   the columns of its projected schema.
+	template <typename MakeData>
+	void filteredDataPointLogged(const MakeData& make_data) {
+		auto lists = observers.Read();
+		for (auto& observer : lists->filteredObservers) {
+			if (observer.columns)
+				observer.observer->onDataPointLogged(make_data(*observer.columns));
+		}
+	};
+	// Like filteredDataPointLogged(..) for count data points: make_data(index,
+	//   columns) returns the map of the data point at index. Each filtered
+	//   observer is notified once for all of them (see LogBatchObserver.h).
+	template <typename MakeData>
+	void filteredDataPointsLogged(size_t count, const MakeData& make_data) {
+		auto lists = observers.Read();
+		std::vector<std::map<std::string, std::string>> data;
+		for (auto& observer : lists->filteredObservers) {
+			if (!observer.columns)
+				continue;
+			data.clear();
+			data.reserve(count);
+			for (size_t index = 0; index < count; index++)
+				data.push_back(make_data(index, *observer.columns));
+			notifyBatch(observer.observer.get(), data);
+		}
+	};
+	void schemaPublished(std::shared_ptr<const LogSchema> schema) {
+		publishedSchema = schema;
+		observers.Update([&](ObserverLists& lists) {
+			lists.schema = schema;
+			for (auto& observer : lists.filteredObservers)
+				observer.columns = observer.filter.Project(schema);
+			for (auto& observer : lists.typedObservers)
+				observer.observer->onSchemaPublished(observer.filter.Project(schema));
+		});
+	};
+	// Every observer gets the same buffer.
+	void typedDataPointLogged(const LogDataPointRef& event) {
+		auto lists = observers.Read();
+		for (auto& observer : lists->typedObservers)
+			observer.observer->onDataPointLogged(event);
+	};
+
+private:
+	struct FilteredObserver {
+		std::shared_ptr<LogObserver> observer;
+		LogColumnFilter filter;
+		std::shared_ptr<const LogSchema> columns;	// Projection of the published schema
+	};
+	struct TypedObserver {
+		std::shared_ptr<TypedLogObserver> observer;
+		LogColumnFilter filter;
+	};
+	// Never changed once published; see CopyOnWriteLogValue.h
+	struct ObserverLists {
+		std::vector<std::shared_ptr<LogObserver>> observers;
+		std::vector<FilteredObserver> filteredObservers;
+		std::vector<TypedObserver> typedObservers;
+		std::shared_ptr<const LogSchema> schema;
+	};
+
+	CopyOnWriteLogValue<ObserverLists> observers;
+
+	static void removeFrom(std::vector<std::shared_ptr<LogObserver>>& list, const LogObserver* observer) {
+		list.erase(std::remove_if(list.begin(), list.end(),
+			[observer](const std::shared_ptr<LogObserver>& entry) { return entry.get() == observer; }), list.end());
+	};
+	static void removeFrom(std::vector<FilteredObserver>& list, const LogObserver* observer) {
+		list.erase(std::remove_if(list.begin(), list.end(),
+			[observer](const FilteredObserver& entry) { return entry.observer.get() == observer; }), list.end());
+	};
+	static void removeFrom(std::vector<TypedObserver>& list, const TypedLogObserver* observer) {
+		list.erase(std::remove_if(list.begin(), list.end(),
+			[observer](const TypedObserver& entry) { return entry.observer.get() == observer; }), list.end());
+	};
+	static void setDrainScheduler(const std::shared_ptr<QueuedLogObserver>& queued,
+		std::function<void(std::shared_ptr<QueuedLogObserver>)> schedule_drain) {
+		std::weak_ptr<QueuedLogObserver> weakQueued = queued;
+		queued->SetWakeCallback([weakQueued, schedule_drain]() {
+			if (auto queuedObserver = weakQueued.lock())
+				schedule_drain(queuedObserver);
+		});
+	};
+	void notifyBatch(LogObserver* observer, const std::vector<std::map<std::string, std::string>>& data) {
+		if (auto batchObserver = dynamic_cast<LogBatchObserver*>(observer)) {
+			batchObserver->onDataPointsLogged(data);
+			return;
+		}
+		for (auto& dataPoint : data)
+			observer->onDataPointLogged(dataPoint);
+	};
 
 };
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <filesystem>
+
+#include "LogOutputFile.h"
+
+using namespace std;
+
+
+bool LogOutputFile::Open(const string& file_path) {
+	Close();
+	if (!OpenFile(file_path))
+		return false;
+
+	filePath = file_path;
+	bytesWritten = 0;
+	sizeAtOpen = GetOpenedFileSize();
+	linesSinceCommit = 0;
+	lastCommit = chrono::steady_clock::now();
+	return true;
+}
+
+uint64_t LogOutputFile::GetSizeAtOpen() const {
+	return sizeAtOpen;
+}
+
+uint64_t LogOutputFile::GetOpenedFileSize() const {
+	error_code ignored;
+	uintmax_t size = filesystem::file_size(filePath, ignored);
+	return size == uintmax_t(-1) ? 0 : uint64_t(size);
+}
+
+bool LogOutputFile::IsOpen() const {
+	return IsFileOpen();
+}
+
+const string& LogOutputFile::GetFilePath() const {
+	return filePath;
+}
+
+void LogOutputFile::Close() {
+	if (!IsFileOpen())
+		return;
+	if (policy.durabilityMode == LogDurabilityMode::OS_BUFFERED)
+		Flush();
+	else
+		Commit();
+	CloseFile();
+	filePath = "";
+}
+
+bool LogOutputFile::Write(const string& text, size_t line_count) {
+	if (!IsFileOpen())
+		return false;
+
+	if (GetPendingBytes() == 0)
+		oldestPendingWrite = chrono::steady_clock::now();
+	if (!AppendPending(text))
+		return false;
+	bytesWritten += text.size();
+	linesSinceCommit += line_count;
+
+	if (policy.durabilityMode == LogDurabilityMode::SYNC_EVERY_LINE or GroupCommitDue())
+		return Commit();
+	if (FlushPolicyReached())
+		return Flush();
+	return true;
+}
+
+bool LogOutputFile::FlushIfDue() {
+	if (GroupCommitDue())
+		return Commit();
+	if (!FlushPolicyReached())
+		return true;
+	return Flush();
+}
+
+bool LogOutputFile::Commit() {
+	if (!IsFileOpen())
+		return false;
+
+	auto startTime = chrono::steady_clock::now();
+	bool success = Flush() and SyncToDisk();
+	auto endTime = chrono::steady_clock::now();
+
+	double latencyInMs = chrono::duration<double, milli>(endTime - startTime).count();
+	commitLatency.commits++;
+	commitLatency.lastInMs = latencyInMs;
+	commitLatency.maxInMs = max(commitLatency.maxInMs, latencyInMs);
+	commitLatency.meanInMs += (latencyInMs - commitLatency.meanInMs) / commitLatency.commits;
+
+	linesSinceCommit = 0;
+	lastCommit = endTime;
+	return success;
+}
+
+void LogOutputFile::SetPolicy(const LogOutputPolicy& _policy) {
+	policy = _policy;
+	if (policy.groupCommitLines == 0)
+		policy.groupCommitLines = 1;
+	OnPolicyChanged();
+}
+
+const LogOutputPolicy& LogOutputFile::GetPolicy() const {
+	return policy;
+}
+
+LogCommitLatencyStats LogOutputFile::GetCommitLatencyStats() const {
+	return commitLatency;
+}
+
+uint64_t LogOutputFile::GetBytesWritten() const {
+	return bytesWritten;
+}
+
+bool LogOutputFile::FlushPolicyReached() const {
+	size_t pendingBytes = GetPendingBytes();
+	if (pendingBytes == 0)
+		return false;
+	if (pendingBytes >= policy.maxBufferedBytes)
+		return true;
+	return chrono::steady_clock::now() - oldestPendingWrite >= chrono::milliseconds(policy.maxBufferAgeInMs);
+}
+
+bool LogOutputFile::GroupCommitDue() const {
+	if (policy.durabilityMode != LogDurabilityMode::GROUP_COMMIT or linesSinceCommit == 0)
+		return false;
+	if (linesSinceCommit >= policy.groupCommitLines)
+		return true;
+	return chrono::steady_clock::now() - lastCommit >= chrono::milliseconds(policy.groupCommitIntervalInMs);
+}
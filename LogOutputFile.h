@@ -0,0 +1,127 @@
+/**
+* Log Output File : Base class for log file backends that stay open for a
+*	whole logging session (buffered, memory-mapped, ...).
+*
+* - Implements the flush and durability policies once for every backend.
+*		Backends only provide the primitives: opening, appending pending text,
+*		handing pending text to the operating system, and syncing to disk.
+* - Every Write(..) counts as one line for group commit purposes, unless the
+*		caller passes the number of lines in the text.
+*
+*
+* @file LogOutputFile.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+
+const size_t DEFAULT_LOG_FLUSH_SIZE_IN_BYTES = 64 * 1024;
+const unsigned int DEFAULT_LOG_FLUSH_AGE_IN_MS = 1000;
+const unsigned int DEFAULT_GROUP_COMMIT_LINES = 100;
+const unsigned int DEFAULT_GROUP_COMMIT_INTERVAL_IN_MS = 1000;
+
+
+// When written log data is forced to stable storage.
+enum class LogDurabilityMode {
+	OS_BUFFERED,		// Never sync; the operating system decides when data reaches the disk
+	SYNC_EVERY_LINE,	// Flush and sync after every line
+	GROUP_COMMIT		// Flush and sync after N lines or T milliseconds, whichever comes first
+};
+
+
+// Flush and durability settings shared by all output backends.
+struct LogOutputPolicy {
+	size_t maxBufferedBytes = DEFAULT_LOG_FLUSH_SIZE_IN_BYTES;
+	unsigned int maxBufferAgeInMs = DEFAULT_LOG_FLUSH_AGE_IN_MS;
+	LogDurabilityMode durabilityMode = LogDurabilityMode::OS_BUFFERED;
+	unsigned int groupCommitLines = DEFAULT_GROUP_COMMIT_LINES;
+	unsigned int groupCommitIntervalInMs = DEFAULT_GROUP_COMMIT_INTERVAL_IN_MS;
+};
+
+
+// Time spent flushing and syncing, measured per commit.
+struct LogCommitLatencyStats {
+	unsigned long long commits = 0;
+	double lastInMs = 0.0;
+	double maxInMs = 0.0;
+	double meanInMs = 0.0;
+};
+
+
+class LogOutputFile {
+
+public:
+	LogOutputFile() = default;
+	virtual ~LogOutputFile() = default;
+
+	LogOutputFile(const LogOutputFile&) = delete;
+	LogOutputFile& operator=(const LogOutputFile&) = delete;
+
+	// Open (or create) the file for appending. Closes any previously open file first.
+	bool Open(const std::string& file_path);
+	bool IsOpen() const;
+	const std::string& GetFilePath() const;
+
+	// Flush (and sync, unless OS_BUFFERED) pending text, then close the file.
+	void Close();
+
+	// Append text. Returns false if the file is not open or a flush or commit
+	//   triggered by this write failed.
+	bool Write(const std::string& text, size_t line_count = 1);
+
+	// Hand all pending text to the operating system.
+	virtual bool Flush() = 0;
+
+	// Flush or commit only if the policy says so. Lets callers apply the time
+	//   limits while no new text is being written.
+	bool FlushIfDue();
+
+	// Flush pending text and force it to stable storage.
+	bool Commit();
+
+	void SetPolicy(const LogOutputPolicy& policy);
+	const LogOutputPolicy& GetPolicy() const;
+
+	LogCommitLatencyStats GetCommitLatencyStats() const;
+
+	// Bytes the file has grown by since it was opened, including pending text.
+	virtual std::uint64_t GetBytesWritten() const;
+
+	// Bytes of log data the file held when it was opened, after the backend
+	//   dropped what a crash left behind (e.g. the preallocated tail of a
+	//   memory-mapped file).
+	std::uint64_t GetSizeAtOpen() const;
+
+
+protected:
+	LogOutputPolicy policy;
+
+	virtual bool OpenFile(const std::string& file_path) = 0;
+	virtual void CloseFile() = 0;
+	virtual bool IsFileOpen() const = 0;
+	virtual bool AppendPending(const std::string& text) = 0;
+	virtual size_t GetPendingBytes() const = 0;
+	virtual bool SyncToDisk() = 0;
+	virtual void OnPolicyChanged() {}
+	// Called by Open(..) once the file is open. Default: the size on disk.
+	virtual std::uint64_t GetOpenedFileSize() const;
+
+
+private:
+	std::string filePath;
+	std::uint64_t bytesWritten = 0;
+	std::uint64_t sizeAtOpen = 0;
+	std::chrono::steady_clock::time_point oldestPendingWrite;
+	size_t linesSinceCommit = 0;
+	std::chrono::steady_clock::time_point lastCommit;
+	LogCommitLatencyStats commitLatency;
+
+	bool FlushPolicyReached() const;
+	bool GroupCommitDue() const;
+
+};
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+
+#include "LogRollup.h"
+
+using namespace std;
+
+
+static void AppendNumber(string& out, double value) {
+	char buffer[32];
+	to_chars_result result = to_chars(buffer, buffer + sizeof(buffer), value);
+	out.append(buffer, result.ptr);
+}
+
+
+string MakeLogRollupPath(const string& log_file_path, unsigned int bucket_seconds) {
+	filesystem::path path(log_file_path);
+	string fileName = path.stem().string() + "_rollup_" + to_string(bucket_seconds) + "s.csv";
+	return (path.parent_path() / fileName).string();
+}
+
+
+LogRollup::LogRollup(unsigned int bucket_seconds, const vector<string>& column_names) :
+	bucketSeconds(max(bucket_seconds, 1u)), columnNames(column_names), stats(column_names.size()) {
+}
+
+LogRollup::~LogRollup() {
+	Close();
+}
+
+bool LogRollup::Open(const string& file_path) {
+	Close();
+
+	error_code sizeError;
+	uintmax_t existingBytes = filesystem::file_size(file_path, sizeError);
+	bool newFile = sizeError or existingBytes == 0;
+	FILE* file = fopen(file_path.c_str(), "ab");
+	if (file == nullptr)
+		return false;
+
+	// Only a new file gets a header line
+	bool success = true;
+	if (newFile) {
+		line = "Date,Time,Rows";
+		for (const string& name : columnNames)
+			line += "," + name + " min," + name + " max," + name + " mean";
+		line += '\n';
+		success = fwrite(line.data(), 1, line.size(), file) == line.size();
+	}
+	fclose(file);
+
+	if (success)
+		filePath = file_path;
+	return success;
+}
+
+bool LogRollup::Close() {
+	bool success = WriteBucket();
+	filePath = "";
+	return success;
+}
+
+bool LogRollup::Add(time_t time, const vector<double>& values) {
+	time_t start = time - time % time_t(bucketSeconds);
+	bool success = true;
+	if (bucketRows > 0 and start != bucketStart)
+		success = WriteBucket();
+	bucketStart = start;
+	bucketRows++;
+
+	size_t columnCount = min(values.size(), stats.size());
+	for (size_t col = 0; col < columnCount; col++) {
+		double value = values[col];
+		if (isnan(value))
+			continue;
+		ColumnStats& column = stats[col];
+		if (column.count == 0) {
+			column.min = value;
+			column.max = value;
+		}
+		else {
+			column.min = min(column.min, value);
+			column.max = max(column.max, value);
+		}
+		column.sum += value;
+		column.count++;
+	}
+	return success;
+}
+
+unsigned int LogRollup::GetBucketSeconds() const {
+	return bucketSeconds;
+}
+
+bool LogRollup::WriteBucket() {
+	if (bucketRows == 0)
+		return true;
+
+	char date[16] = "";
+	char time[16] = "";
+	tm bucketTime = *localtime(&bucketStart);
+	strftime(date, sizeof(date), "%Y-%m-%d", &bucketTime);
+	strftime(time, sizeof(time), "%H:%M:%S", &bucketTime);
+
+	line = date;
+	line += ',';
+	line += time;
+	line += ',';
+	line += to_string(bucketRows);
+	for (ColumnStats& column : stats) {
+		line += ',';
+		if (column.count > 0)
+			AppendNumber(line, column.min);
+		line += ',';
+		if (column.count > 0)
+			AppendNumber(line, column.max);
+		line += ',';
+		if (column.count > 0)
+			AppendNumber(line, column.sum / double(column.count));
+		column = ColumnStats();
+	}
+	line += '\n';
+	bucketRows = 0;
+
+	if (filePath.empty())
+		return false;
+	FILE* file = fopen(filePath.c_str(), "ab");
+	if (file == nullptr)
+		return false;
+	bool success = fwrite(line.data(), 1, line.size(), file) == line.size();
+	return fclose(file) == 0 and success;
+}
@@ -0,0 +1,84 @@
+/**
+* Log Rollup : Streaming per-bucket statistics of the numeric columns of a
+*	log, written to a small CSV file next to the raw log.
+*
+* - Every data point is added to the bucket of the second it was logged in.
+*		Per bucket, the number of rows and the min, max and mean of every
+*		rolled-up column are kept; only these few numbers live in memory.
+* - When a data point falls into a new bucket, the finished bucket is appended
+*		to the rollup file as one line. Close() writes the current, partial
+*		bucket, so a session that is reopened within the same bucket writes a
+*		second line for it; combine such lines weighted by their row counts.
+* - Buckets are aligned to multiples of their size since the epoch (UTC), so
+*		minute and hour buckets line up with the local clock in whole-hour time
+*		zones.
+* - The file starts with Date and Time columns, like a log file, so it can be
+*		loaded with LogFileReader. Columns per rolled-up column: "<name> min",
+*		"<name> max", "<name> mean". Empty when a bucket has no value for it.
+*
+* Rollup file example (bucket_seconds 60, one column "PEC"):
+*	Date,Time,Rows,PEC min,PEC max,PEC mean
+*	2026-10-17,14:03:00,600,49.1,50.2,49.73
+*
+*
+* @file LogRollup.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+
+const unsigned int LOG_ROLLUP_MINUTE = 60;
+const unsigned int LOG_ROLLUP_HOUR = 60 * 60;
+
+
+// Returns "<dir>/<stem>_rollup_<bucket_seconds>s.csv" for log_file_path.
+std::string MakeLogRollupPath(const std::string& log_file_path, unsigned int bucket_seconds);
+
+
+class LogRollup {
+
+public:
+	LogRollup(unsigned int bucket_seconds, const std::vector<std::string>& column_names);
+	// Writes the current bucket.
+	~LogRollup();
+
+	LogRollup(const LogRollup&) = delete;
+	LogRollup& operator=(const LogRollup&) = delete;
+
+	// Append buckets to file_path, creating it with a header line if needed.
+	//   Writes the current bucket to the previous file first.
+	bool Open(const std::string& file_path);
+	// Write the current bucket and stop.
+	bool Close();
+
+	// Add one data point. values holds one value per column, NaN for none.
+	//   Returns false if a finished bucket could not be written.
+	bool Add(std::time_t time, const std::vector<double>& values);
+
+	unsigned int GetBucketSeconds() const;
+
+
+private:
+	struct ColumnStats {
+		double min = 0.0;
+		double max = 0.0;
+		double sum = 0.0;
+		size_t count = 0;
+	};
+
+	unsigned int bucketSeconds;
+	std::vector<std::string> columnNames;
+	std::string filePath;
+	std::vector<ColumnStats> stats;
+	std::time_t bucketStart = 0;
+	size_t bucketRows = 0;
+	std::string line;
+
+	bool WriteBucket();
+
+};
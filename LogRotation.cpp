@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+#include "LogRotation.h"
+#include "LogChecksum.h"
+#include "LogCompression.h"
+#include "../ErrorMessageStream.h"
+
+using namespace std;
+
+
+const char LOG_INDEX_HEADER[] = "Segment,Opened,Closed,Lines,Bytes,CRC32\n";
+
+
+time_t GetNextLogRotationTime(LogRotationBoundary boundary, time_t now) {
+	if (boundary == LogRotationBoundary::NONE)
+		return 0;
+
+	tm boundaryTime = *localtime(&now);
+	boundaryTime.tm_min = 0;
+	boundaryTime.tm_sec = 0;
+	boundaryTime.tm_isdst = -1;
+	if (boundary == LogRotationBoundary::HOURLY)
+		boundaryTime.tm_hour += 1;
+	else {
+		boundaryTime.tm_hour = 0;
+		boundaryTime.tm_mday += 1;
+	}
+	// mktime(..) normalizes the overflowing field into the next hour/day/month
+	return mktime(&boundaryTime);
+}
+
+string MakeLogSegmentPath(const string& log_file_path, unsigned int index) {
+	filesystem::path path(log_file_path);
+	string number = to_string(index);
+	if (number.size() < 4)
+		number.insert(0, 4 - number.size(), '0');
+	string fileName = path.stem().string() + "_" + number + path.extension().string();
+	return (path.parent_path() / fileName).string();
+}
+
+string MakeLogIndexPath(const string& log_file_path) {
+	return filesystem::path(log_file_path).replace_extension(".index").string();
+}
+
+
+LogSegmentFinalizer::LogSegmentFinalizer() {
+	finalizerThread = thread(&LogSegmentFinalizer::FinalizerThreadLoop, this);
+}
+
+LogSegmentFinalizer::~LogSegmentFinalizer() {
+	{
+		lock_guard<mutex> lock(jobsMutex);
+		stopRequested = true;
+	}
+	jobsChanged.notify_all();
+	if (finalizerThread.joinable())
+		finalizerThread.join();
+}
+
+void LogSegmentFinalizer::Enqueue(LogSegmentJob job) {
+	{
+		lock_guard<mutex> lock(jobsMutex);
+		jobs.push_back(move(job));
+	}
+	jobsChanged.notify_all();
+}
+
+void LogSegmentFinalizer::WaitUntilIdle() {
+	unique_lock<mutex> lock(jobsMutex);
+	jobsChanged.wait(lock, [this]() { return jobs.empty() and !busy; });
+}
+
+size_t LogSegmentFinalizer::GetFinalizedSegmentCount() const {
+	lock_guard<mutex> lock(jobsMutex);
+	return finalizedSegments;
+}
+
+void LogSegmentFinalizer::FinalizerThreadLoop() {
+	unique_lock<mutex> lock(jobsMutex);
+	while (true) {
+		jobsChanged.wait(lock, [this]() { return stopRequested or !jobs.empty(); });
+		// Remaining jobs are still finished when stopping
+		if (jobs.empty())
+			return;
+
+		LogSegmentJob job = move(jobs.front());
+		jobs.pop_front();
+		busy = true;
+		lock.unlock();
+
+		bool finalized = Finalize(job);
+
+		lock.lock();
+		busy = false;
+		if (finalized)
+			finalizedSegments++;
+		jobsChanged.notify_all();
+	}
+}
+
+// Reads the next block of segment text into block, decompressing it if the
+//   segment was written compressed. Returns 0 at the end of the segment.
+static size_t ReadSegmentBlock(FILE* source, bool compressed, string& block, string& scratch, bool& failed) {
+	if (!compressed) {
+		size_t read = fread(&block[0], 1, LOG_COMPRESSION_BLOCK_SIZE, source);
+		failed = read == 0 and ferror(source) != 0;
+		return read;
+	}
+	bool corrupt = false;
+	while (ReadCompressedLogBlock(source, block, scratch, corrupt)) {
+		if (!block.empty())
+			return block.size();
+	}
+	failed = corrupt or ferror(source) != 0;
+	return 0;
+}
+
+bool LogSegmentFinalizer::Finalize(const LogSegmentJob& job) {
+	FILE* source = fopen(job.segmentPath.c_str(), "rb");
+	if (source == nullptr) {
+		e << "Failed to open log segment \"" << job.segmentPath << "\" for finalizing." << endl;
+		return false;
+	}
+	if (job.compressed and !ReadCompressedLogFileHeader(source)) {
+		e << "Log segment \"" << job.segmentPath << "\" is not a compressed log file." << endl;
+		fclose(source);
+		return false;
+	}
+
+	string compressedPath = job.segmentPath + LOG_COMPRESSED_FILE_EXTENSION;
+	FILE* target = nullptr;
+	bool compressed = false;
+	if (job.compress and !job.compressed) {
+		target = fopen(compressedPath.c_str(), "wb");
+		compressed = target != nullptr and WriteCompressedLogFileHeader(target);
+	}
+
+	string block(LOG_COMPRESSION_BLOCK_SIZE, '\0');
+	string scratch;
+	string readScratch;
+	uint32_t crc = 0;
+	uint64_t bytes = 0;
+	size_t lines = 0;
+	char lastByte = '\n';
+	bool readFailed = false;
+
+	while (true) {
+		size_t read = ReadSegmentBlock(source, job.compressed, block, readScratch, readFailed);
+		if (read == 0)
+			break;
+		crc = ComputeLogCrc32(block.data(), read, crc);
+		bytes += read;
+		lines += count(block.begin(), block.begin() + read, '\n');
+		lastByte = block[read - 1];
+		if (compressed)
+			compressed = WriteCompressedLogBlock(target, block.data(), read, scratch);
+	}
+	fclose(source);
+	if (lastByte != '\n')
+		lines++;
+
+	if (target != nullptr)
+		compressed = fclose(target) == 0 and compressed and !readFailed;
+
+	if (readFailed) {
+		e << "Failed to read log segment \"" << job.segmentPath << "\" for finalizing." << endl;
+		if (target != nullptr)
+			remove(compressedPath.c_str());
+		return false;
+	}
+
+	string finalPath = job.segmentPath;
+	if (job.compress and !job.compressed) {
+		if (compressed) {
+			remove(job.segmentPath.c_str());
+			finalPath = compressedPath;
+		}
+		else {
+			e << "Failed to compress log segment \"" << job.segmentPath << "\"." << endl;
+			remove(compressedPath.c_str());
+		}
+	}
+
+	return AppendIndexRow(job, finalPath, lines, bytes, crc);
+}
+
+bool LogSegmentFinalizer::AppendIndexRow(const LogSegmentJob& job, const string& segment_path,
+	size_t lines, uint64_t bytes, uint32_t crc) {
+
+	error_code ignored;
+	bool newIndex = !filesystem::exists(job.indexPath, ignored);
+
+	FILE* index = fopen(job.indexPath.c_str(), "ab");
+	if (index == nullptr) {
+		e << "Failed to open log index \"" << job.indexPath << "\"." << endl;
+		return false;
+	}
+
+	string row = newIndex ? LOG_INDEX_HEADER : "";
+	row += filesystem::path(segment_path).filename().string() + ",";
+	row += job.openedAt + ",";
+	row += job.closedAt + ",";
+	row += to_string(lines) + ",";
+	row += to_string(bytes) + ",";
+	row += FormatLogCrc32(crc) + "\n";
+
+	bool success = fwrite(row.data(), 1, row.size(), index) == row.size();
+	success = fclose(index) == 0 and success;
+	if (!success)
+		e << "Failed to write log index \"" << job.indexPath << "\"." << endl;
+	return success;
+}
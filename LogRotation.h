@@ -0,0 +1,108 @@
+/**
+* Log Rotation : Policy for splitting a long logging session into segment
+*	files, and the background thread that finalizes closed segments.
+*
+* - When a rotation limit is reached, the logger renames its log file to the
+*		next free segment name (e.g. "myLog_0001.log" for "myLog.log") and starts
+*		a fresh file at the original path. The current log therefore always
+*		lives at the path chosen with SetFilePath(..).
+* - Closed segments are handed to a LogSegmentFinalizer, which on its own
+*		thread:
+*		- computes the CRC-32 of the segment and counts its lines (of the
+*			decompressed text, for segments written in LogWriteMode::COMPRESSED),
+*		- optionally compresses it (see LogCompression.h) and removes the
+*			uncompressed segment,
+*		- appends a row for it to the index file next to the log
+*			(e.g. "myLog.index"): segment file, opened and closed date/time,
+*			lines, bytes and CRC-32 of the uncompressed text.
+*
+*
+* @file LogRotation.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+// Wall-clock boundaries (local time) at which a new segment is started.
+enum class LogRotationBoundary {
+	NONE,
+	HOURLY,
+	DAILY
+};
+
+// Limits that start a new segment. 0 / NONE disables a limit.
+struct LogRotationPolicy {
+	size_t maxBytes = 0;			// Approximate; counted as written, after encryption and compression
+	size_t maxRows = 0;				// Data points, not counting header or custom lines
+	LogRotationBoundary boundary = LogRotationBoundary::NONE;
+	bool compress = false;			// Compress finalized segments
+
+	bool IsEnabled() const {
+		return maxBytes > 0 or maxRows > 0 or boundary != LogRotationBoundary::NONE;
+	}
+};
+
+// Returns the first boundary after now, or 0 for LogRotationBoundary::NONE.
+std::time_t GetNextLogRotationTime(LogRotationBoundary boundary, std::time_t now);
+
+// Returns "<dir>/<stem>_<index>.<ext>" for log_file_path, with index padded to
+//   4 digits.
+std::string MakeLogSegmentPath(const std::string& log_file_path, unsigned int index);
+
+// Returns "<dir>/<stem>.index" for log_file_path.
+std::string MakeLogIndexPath(const std::string& log_file_path);
+
+
+// A closed segment waiting to be finalized.
+struct LogSegmentJob {
+	std::string segmentPath;
+	std::string indexPath;
+	std::string openedAt;		// Date and time the segment was started
+	std::string closedAt;		// Date and time the segment was closed
+	bool compress = false;
+	bool compressed = false;	// Written compressed (LOG_COMPRESSED_FILE_EXTENSION); compress is ignored
+};
+
+
+class LogSegmentFinalizer {
+
+public:
+	LogSegmentFinalizer();
+	// Finalizes all segments still waiting before returning.
+	~LogSegmentFinalizer();
+
+	LogSegmentFinalizer(const LogSegmentFinalizer&) = delete;
+	LogSegmentFinalizer& operator=(const LogSegmentFinalizer&) = delete;
+
+	void Enqueue(LogSegmentJob job);
+
+	// Blocks until every segment enqueued so far has been finalized.
+	void WaitUntilIdle();
+
+	size_t GetFinalizedSegmentCount() const;
+
+
+private:
+	mutable std::mutex jobsMutex;
+	std::condition_variable jobsChanged;
+	std::deque<LogSegmentJob> jobs;
+	bool busy = false;
+	bool stopRequested = false;
+	size_t finalizedSegments = 0;
+	std::thread finalizerThread;
+
+	void FinalizerThreadLoop();
+	bool Finalize(const LogSegmentJob& job);
+	bool AppendIndexRow(const LogSegmentJob& job, const std::string& segment_path,
+		size_t lines, std::uint64_t bytes, std::uint32_t crc);
+
+};
@@ -0,0 +1,123 @@
+#include <charconv>
+#include <cmath>
+
+#include "LogRow.h"
+
+using namespace std;
+
+// Large enough for any float in fixed notation plus the requested digits
+const size_t FORMAT_BUFFER_SIZE = 128;
+
+
+void LogRow::Clear() {
+	values.clear();
+	text.clear();
+}
+
+void LogRow::Reserve(size_t value_count, size_t text_bytes) {
+	values.reserve(value_count);
+	text.reserve(text_bytes);
+}
+
+void LogRow::AddFloat(float value) {
+	LogValue logValue;
+	logValue.type = LogColumnType::FLOAT;
+	logValue.floatValue = value;
+	values.push_back(logValue);
+}
+
+void LogRow::AddInt(int64_t value) {
+	LogValue logValue;
+	logValue.type = LogColumnType::INT;
+	logValue.intValue = value;
+	values.push_back(logValue);
+}
+
+void LogRow::AddString(string_view value) {
+	LogValue logValue;
+	logValue.type = LogColumnType::STRING;
+	logValue.textOffset = uint32_t(text.size());
+	logValue.textLength = uint32_t(value.size());
+	text.append(value.data(), value.size());
+	values.push_back(logValue);
+}
+
+void LogRow::Append(const LogRow& other) {
+	uint32_t textShift = uint32_t(text.size());
+	text += other.text;
+	for (LogValue value : other.values) {
+		value.textOffset += textShift;
+		values.push_back(value);
+	}
+}
+
+size_t LogRow::Size() const {
+	return values.size();
+}
+
+const LogValue& LogRow::operator[](size_t index) const {
+	return values[index];
+}
+
+string_view LogRow::GetText(size_t index) const {
+	const LogValue& value = values[index];
+	return string_view(text.data() + value.textOffset, value.textLength);
+}
+
+void LogRow::AppendFormatted(size_t index, int precision, string& out) const {
+	const LogValue& value = values[index];
+	char buffer[FORMAT_BUFFER_SIZE];
+	to_chars_result result{ buffer, errc() };
+
+	switch (value.type) {
+	case LogColumnType::FLOAT:
+		if (isnan(value.floatValue)) {
+			out += "nan";
+			return;
+		}
+		if (precision == LOG_PRECISION_SHORTEST)
+			result = to_chars(buffer, buffer + sizeof(buffer), value.floatValue);
+		else
+			result = to_chars(buffer, buffer + sizeof(buffer), value.floatValue, chars_format::fixed, precision);
+		break;
+	case LogColumnType::INT:
+		result = to_chars(buffer, buffer + sizeof(buffer), value.intValue);
+		break;
+	default:
+		out.append(text.data() + value.textOffset, value.textLength);
+		return;
+	}
+
+	if (result.ec == errc())
+		out.append(buffer, result.ptr);
+}
+
+float LogRow::GetAsFloat(size_t index) const {
+	const LogValue& value = values[index];
+	if (value.type == LogColumnType::FLOAT)
+		return value.floatValue;
+	if (value.type == LogColumnType::INT)
+		return float(value.intValue);
+
+	string_view valueText = GetText(index);
+	float parsed = 0.0f;
+	auto result = from_chars(valueText.data(), valueText.data() + valueText.size(), parsed);
+	if (result.ec != errc() or valueText.empty())
+		return nanf("");
+	return parsed;
+}
+
+int64_t LogRow::GetAsInt(size_t index, int64_t missing_int) const {
+	const LogValue& value = values[index];
+	if (value.type == LogColumnType::INT)
+		return value.intValue;
+	if (value.type == LogColumnType::FLOAT)
+		return isnan(value.floatValue) ? missing_int : int64_t(value.floatValue);
+
+	string_view valueText = GetText(index);
+	int64_t parsed = 0;
+	auto result = from_chars(valueText.data(), valueText.data() + valueText.size(), parsed);
+	if (result.ec != errc() or valueText.empty())
+		return missing_int;
+	return parsed;
+}
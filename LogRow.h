@@ -0,0 +1,73 @@
+/**
+* Log Row : Reusable, typed row of values for LoggerBase::LogDataPoint(..).
+*
+* - Values are stored in their native type (float, integer or text) and are
+*		only turned into text by the outputs that need text.
+* - Text values are packed into one shared character buffer.
+* - Clear() keeps all capacity, so a row that is filled and logged over and
+*		over again stops allocating after the first few data points.
+*
+* Example usage:
+*
+*	LogRow row;
+*	row.AddFloat(49.5f);
+*	row.AddInt(1000);
+*	row.AddString("");
+*	logger.LogDataPoint(row);
+*	row.Clear();
+*
+*
+* @file LogRow.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LogSchema.h"
+
+
+struct LogValue {
+	LogColumnType type = LogColumnType::STRING;
+	float floatValue = 0.0f;
+	std::int64_t intValue = 0;
+	std::uint32_t textOffset = 0;	// Position of a STRING value in the row's text buffer
+	std::uint32_t textLength = 0;
+};
+
+
+class LogRow {
+
+public:
+	void Clear();
+	void Reserve(size_t value_count, size_t text_bytes);
+
+	void AddFloat(float value);
+	void AddInt(std::int64_t value);
+	void AddString(std::string_view value);
+	// Append all values of another row.
+	void Append(const LogRow& other);
+
+	size_t Size() const;
+	const LogValue& operator[](size_t index) const;
+	std::string_view GetText(size_t index) const;
+
+	// Append the value at index to out as text. FLOAT values use precision
+	//   digits after the decimal point (see LOG_PRECISION_SHORTEST).
+	void AppendFormatted(size_t index, int precision, std::string& out) const;
+
+	// Read the value at index as the requested type, converting if necessary.
+	//   Text that does not parse becomes NaN (float) or missing_int (integer).
+	float GetAsFloat(size_t index) const;
+	std::int64_t GetAsInt(size_t index, std::int64_t missing_int) const;
+
+
+private:
+	std::vector<LogValue> values;
+	std::string text;
+
+};
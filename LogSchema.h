@@ -0,0 +1,82 @@
+// Column descriptions shared by the logger and its output formats.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// Value type of a logged column. Text output is unaffected; typed outputs
+// such as the columnar log format store each column in its native type.
+enum class LogColumnType : std::uint8_t {
+	STRING = 0,
+	FLOAT = 1,
+	INT = 2
+};
+
+inline std::string GetLogColumnTypeName(LogColumnType type) {
+	switch (type) {
+	case LogColumnType::FLOAT: return "float";
+	case LogColumnType::INT: return "int";
+	default: return "string";
+	}
+}
+
+
+// Digits after the decimal point used when a FLOAT value is formatted as text.
+// LOG_PRECISION_SHORTEST uses the shortest text that reads back as the same value.
+const int LOG_PRECISION_SHORTEST = -1;
+
+
+// How a column's values are stored and formatted.
+struct LogColumnFormat {
+	LogColumnType type = LogColumnType::STRING;
+	int precision = LOG_PRECISION_SHORTEST;
+};
+
+
+// Ids of the columns every logger starts with.
+const size_t LOG_DATE_COLUMN_ID = 0;
+const size_t LOG_TIME_COLUMN_ID = 1;
+const size_t LOG_COLUMN_NOT_FOUND = size_t(-1);
+
+
+// One column of a LogSchema.
+struct LogColumnInfo {
+	size_t id = 0;			// Index of the column's value in every row logged with the schema
+	std::string name;
+	std::string category;	// E.g. "Temperatures"; empty if the column has none
+	std::string unit;		// E.g. "A"; empty if the column has none
+	LogColumnFormat format;
+};
+
+
+// Columns of a logger in header line order. In a logger's own schema a
+// column's id is its position; a schema projected by a LogColumnFilter only
+// holds some of the columns, but they keep their ids.
+class LogSchema {
+
+public:
+	LogSchema() = default;
+	explicit LogSchema(std::vector<LogColumnInfo> _columns) : columns(std::move(_columns)) {}
+
+	size_t Size() const { return columns.size(); }
+	const LogColumnInfo& operator[](size_t position) const { return columns[position]; }
+	const std::vector<LogColumnInfo>& GetColumns() const { return columns; }
+
+	// Id of the named column, or LOG_COLUMN_NOT_FOUND.
+	size_t FindColumn(const std::string& name) const {
+		for (const LogColumnInfo& column : columns) {
+			if (column.name == name)
+				return column.id;
+		}
+		return LOG_COLUMN_NOT_FOUND;
+	}
+
+
+private:
+	std::vector<LogColumnInfo> columns;
+
+};
@@ -0,0 +1,379 @@
+#include <cstring>
+
+#include "LogSeriesCodec.h"
+
+using namespace std;
+
+
+// ----------------------------------------------------------------------------
+// Bit streams (most significant bit first)
+
+class BitWriter {
+public:
+	BitWriter(string& _out) : out(_out) {}
+	~BitWriter() { Finish(); }
+
+	void Write(uint64_t value, unsigned int bit_count) {
+		while (bit_count > 0) {
+			unsigned int take = bit_count < 8 - usedBits ? bit_count : 8 - usedBits;
+			uint64_t bits = (value >> (bit_count - take)) & ((uint64_t(1) << take) - 1);
+			current = uint8_t(current | (bits << (8 - usedBits - take)));
+			usedBits += take;
+			bit_count -= take;
+			if (usedBits == 8) {
+				out += char(current);
+				current = 0;
+				usedBits = 0;
+			}
+		}
+	}
+
+	// Elias gamma code for value >= 1: small values take few bits
+	void WriteGamma(uint64_t value) {
+		unsigned int bitLength = 0;
+		while ((value >> bitLength) > 1)
+			bitLength++;
+		Write(0, bitLength);
+		Write(value, bitLength + 1);
+	}
+
+	void Finish() {
+		if (usedBits > 0)
+			out += char(current);
+		current = 0;
+		usedBits = 0;
+	}
+
+private:
+	string& out;
+	uint8_t current = 0;
+	unsigned int usedBits = 0;
+};
+
+class BitReader {
+public:
+	BitReader(const char* _data, size_t _size) : data(reinterpret_cast<const uint8_t*>(_data)), size(_size) {}
+
+	bool Read(unsigned int bit_count, uint64_t& value) {
+		if (bit_count > size * 8 - position)
+			return false;
+		value = 0;
+		while (bit_count > 0) {
+			unsigned int offset = unsigned(position % 8);
+			unsigned int take = bit_count < 8 - offset ? bit_count : 8 - offset;
+			uint64_t bits = (data[position / 8] >> (8 - offset - take)) & ((1u << take) - 1);
+			value = (value << take) | bits;
+			position += take;
+			bit_count -= take;
+		}
+		return true;
+	}
+
+	bool ReadBit(bool& bit) {
+		uint64_t value = 0;
+		if (!Read(1, value))
+			return false;
+		bit = value != 0;
+		return true;
+	}
+
+	bool ReadGamma(uint64_t& value) {
+		unsigned int bitLength = 0;
+		bool bit = false;
+		while (ReadBit(bit) and !bit) {
+			if (++bitLength > 63)
+				return false;
+		}
+		if (!bit)
+			return false;
+		uint64_t rest = 0;
+		if (!Read(bitLength, rest))
+			return false;
+		value = (uint64_t(1) << bitLength) | rest;
+		return true;
+	}
+
+private:
+	const uint8_t* data;
+	size_t size;
+	size_t position = 0;
+};
+
+
+static unsigned int CountLeadingZeros(uint32_t value) {
+	unsigned int count = 0;
+	while (count < 32 and !(value & (0x80000000u >> count)))
+		count++;
+	return count;
+}
+
+static unsigned int CountTrailingZeros(uint32_t value) {
+	unsigned int count = 0;
+	while (count < 32 and !(value & (1u << count)))
+		count++;
+	return count;
+}
+
+static uint64_t ZigZag(uint64_t value) {
+	return (value << 1) ^ uint64_t(int64_t(value) >> 63);
+}
+
+static uint64_t UnZigZag(uint64_t value) {
+	return (value >> 1) ^ (~(value & 1) + 1);
+}
+
+static uint32_t FloatBits(float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+
+// ----------------------------------------------------------------------------
+// Floats
+//
+//	first value: 32 raw bits
+//	'0' gamma(n)                 the previous value repeats n times
+//	'10' bits                    XOR fits the previous leading/trailing zero window
+//	'11' 5b leading 5b (length-1) bits    XOR with a new window
+
+void EncodeFloatSeries(const float* values, size_t count, string& out) {
+	if (count == 0)
+		return;
+	BitWriter writer(out);
+	uint32_t previous = FloatBits(values[0]);
+	writer.Write(previous, 32);
+
+	unsigned int windowLeading = 0;
+	unsigned int windowTrailing = 0;
+	bool haveWindow = false;
+	size_t i = 1;
+	while (i < count) {
+		uint32_t bits = FloatBits(values[i]);
+		uint32_t delta = bits ^ previous;
+		if (delta == 0) {
+			size_t run = 1;
+			while (i + run < count and FloatBits(values[i + run]) == previous)
+				run++;
+			writer.Write(0, 1);
+			writer.WriteGamma(run);
+			i += run;
+			continue;
+		}
+
+		unsigned int leading = CountLeadingZeros(delta);
+		unsigned int trailing = CountTrailingZeros(delta);
+		if (haveWindow and leading >= windowLeading and trailing >= windowTrailing) {
+			writer.Write(2, 2);
+			writer.Write(delta >> windowTrailing, 32 - windowLeading - windowTrailing);
+		}
+		else {
+			unsigned int length = 32 - leading - trailing;
+			writer.Write(3, 2);
+			writer.Write(leading, 5);
+			writer.Write(length - 1, 5);
+			writer.Write(delta >> trailing, length);
+			windowLeading = leading;
+			windowTrailing = trailing;
+			haveWindow = true;
+		}
+		previous = bits;
+		i++;
+	}
+}
+
+bool DecodeFloatSeries(const char* data, size_t size, size_t count, vector<float>& values) {
+	values.clear();
+	if (count == 0)
+		return true;
+	values.reserve(count);
+
+	BitReader reader(data, size);
+	uint64_t value = 0;
+	if (!reader.Read(32, value))
+		return false;
+	uint32_t previous = uint32_t(value);
+	auto push = [&values](uint32_t bits) {
+		float sample;
+		memcpy(&sample, &bits, sizeof(sample));
+		values.push_back(sample);
+	};
+	push(previous);
+
+	unsigned int windowLeading = 0;
+	unsigned int windowTrailing = 0;
+	bool haveWindow = false;
+	while (values.size() < count) {
+		bool changed = false;
+		if (!reader.ReadBit(changed))
+			return false;
+		if (!changed) {
+			uint64_t run = 0;
+			if (!reader.ReadGamma(run) or run > count - values.size())
+				return false;
+			for (uint64_t r = 0; r < run; r++)
+				push(previous);
+			continue;
+		}
+
+		bool newWindow = false;
+		if (!reader.ReadBit(newWindow))
+			return false;
+		if (newWindow) {
+			uint64_t leading = 0;
+			uint64_t lengthMinusOne = 0;
+			if (!reader.Read(5, leading) or !reader.Read(5, lengthMinusOne) or leading + lengthMinusOne + 1 > 32)
+				return false;
+			windowLeading = unsigned(leading);
+			windowTrailing = 32 - windowLeading - unsigned(lengthMinusOne + 1);
+			haveWindow = true;
+		}
+		else if (!haveWindow)
+			return false;
+
+		uint64_t meaningful = 0;
+		if (!reader.Read(32 - windowLeading - windowTrailing, meaningful))
+			return false;
+		previous ^= uint32_t(meaningful << windowTrailing);
+		push(previous);
+	}
+	return true;
+}
+
+
+// ----------------------------------------------------------------------------
+// Integers
+//
+//	first value: 64 raw bits, then per value the zigzagged delta-of-delta:
+//	'0' gamma(n)          the previous delta repeats n times
+//	'10' 7b / '110' 12b / '1110' 20b / '1111' 64b
+
+void EncodeIntSeries(const int64_t* values, size_t count, string& out) {
+	if (count == 0)
+		return;
+	BitWriter writer(out);
+	writer.Write(uint64_t(values[0]), 64);
+
+	// Unsigned arithmetic wraps instead of overflowing
+	uint64_t previous = uint64_t(values[0]);
+	uint64_t previousDelta = 0;
+	size_t i = 1;
+	while (i < count) {
+		uint64_t delta = uint64_t(values[i]) - previous;
+		if (delta == previousDelta) {
+			size_t run = 1;
+			while (i + run < count and uint64_t(values[i + run]) - uint64_t(values[i + run - 1]) == previousDelta)
+				run++;
+			writer.Write(0, 1);
+			writer.WriteGamma(run);
+			previous = uint64_t(values[i + run - 1]);
+			i += run;
+			continue;
+		}
+
+		uint64_t encoded = ZigZag(delta - previousDelta);
+		if (encoded < (uint64_t(1) << 7)) {
+			writer.Write(2, 2);
+			writer.Write(encoded, 7);
+		}
+		else if (encoded < (uint64_t(1) << 12)) {
+			writer.Write(6, 3);
+			writer.Write(encoded, 12);
+		}
+		else if (encoded < (uint64_t(1) << 20)) {
+			writer.Write(14, 4);
+			writer.Write(encoded, 20);
+		}
+		else {
+			writer.Write(15, 4);
+			writer.Write(encoded, 64);
+		}
+		previous = uint64_t(values[i]);
+		previousDelta = delta;
+		i++;
+	}
+}
+
+bool DecodeIntSeries(const char* data, size_t size, size_t count, vector<int64_t>& values) {
+	values.clear();
+	if (count == 0)
+		return true;
+	values.reserve(count);
+
+	BitReader reader(data, size);
+	uint64_t previous = 0;
+	if (!reader.Read(64, previous))
+		return false;
+	values.push_back(int64_t(previous));
+
+	uint64_t previousDelta = 0;
+	while (values.size() < count) {
+		bool changed = false;
+		if (!reader.ReadBit(changed))
+			return false;
+		if (!changed) {
+			uint64_t run = 0;
+			if (!reader.ReadGamma(run) or run > count - values.size())
+				return false;
+			for (uint64_t r = 0; r < run; r++) {
+				previous += previousDelta;
+				values.push_back(int64_t(previous));
+			}
+			continue;
+		}
+
+		// Count further 1 bits to find the width of the delta-of-delta
+		unsigned int width = 0;
+		const unsigned int widths[] = { 7, 12, 20, 64 };
+		for (unsigned int prefix = 0; prefix < 4; prefix++) {
+			bool more = false;
+			if (prefix == 3)
+				more = true;
+			else if (!reader.ReadBit(more))
+				return false;
+			if (!more or prefix == 3) {
+				width = widths[prefix];
+				break;
+			}
+		}
+
+		uint64_t encoded = 0;
+		if (!reader.Read(width, encoded))
+			return false;
+		previousDelta += UnZigZag(encoded);
+		previous += previousDelta;
+		values.push_back(int64_t(previous));
+	}
+	return true;
+}
+
+
+// ----------------------------------------------------------------------------
+// Dictionary indices: gamma(index + 1) gamma(run length) per run
+
+void EncodeIndexRuns(const uint32_t* values, size_t count, string& out) {
+	BitWriter writer(out);
+	size_t i = 0;
+	while (i < count) {
+		size_t run = 1;
+		while (i + run < count and values[i + run] == values[i])
+			run++;
+		writer.WriteGamma(uint64_t(values[i]) + 1);
+		writer.WriteGamma(run);
+		i += run;
+	}
+}
+
+bool DecodeIndexRuns(const char* data, size_t size, size_t count, vector<uint32_t>& values) {
+	values.clear();
+	values.reserve(count);
+	BitReader reader(data, size);
+	while (values.size() < count) {
+		uint64_t index = 0;
+		uint64_t run = 0;
+		if (!reader.ReadGamma(index) or index - 1 > UINT32_MAX or !reader.ReadGamma(run) or run > count - values.size())
+			return false;
+		values.insert(values.end(), size_t(run), uint32_t(index - 1));
+	}
+	return true;
+}
@@ -0,0 +1,38 @@
+/**
+* Log Series Codec : Compression for columns of slowly changing samples,
+*	such as temperatures, TEC voltages and currents, powers and timestamps.
+*
+* - Floats are XOR-encoded against the previous value (as in Facebook's
+*		Gorilla): a sample that changed only in its low mantissa bits costs a
+*		few bits instead of 32.
+* - Integers are delta-of-delta encoded: regularly spaced timestamps and
+*		steadily counting values cost about one bit each.
+* - Runs of unchanged values (or of unchanged deltas for integers) are stored
+*		as one run length, so a column that does not change during a chunk
+*		costs a few bytes.
+* - Dictionary indices of text columns are run-length encoded.
+* - The decoder needs the number of values; it is stored by the caller (e.g.
+*		the row count of a columnar chunk).
+*
+*
+* @file LogSeriesCodec.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// Append the encoded values to out.
+void EncodeFloatSeries(const float* values, size_t count, std::string& out);
+void EncodeIntSeries(const std::int64_t* values, size_t count, std::string& out);
+void EncodeIndexRuns(const std::uint32_t* values, size_t count, std::string& out);
+
+// Decode count values from data, replacing the contents of values. Return
+//   false if data is truncated or corrupt.
+bool DecodeFloatSeries(const char* data, size_t size, size_t count, std::vector<float>& values);
+bool DecodeIntSeries(const char* data, size_t size, size_t count, std::vector<std::int64_t>& values);
+bool DecodeIndexRuns(const char* data, size_t size, size_t count, std::vector<std::uint32_t>& values);
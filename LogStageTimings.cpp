@@ -0,0 +1,149 @@
+#include <cstdio>
+
+#include "LogStageTimings.h"
+
+using namespace std;
+
+
+string GetLogStageName(const LogStage stage) {
+	switch (stage) {
+	case LogStage::READ_VALUES: return "Read values";
+	case LogStage::FORMAT: return "Format";
+	case LogStage::NOTIFY_OBSERVERS: return "Notify observers";
+	case LogStage::ENCRYPT: return "Encrypt";
+	case LogStage::MEMORY_LOG: return "Memory log";
+	case LogStage::WRITE: return "Write";
+	case LogStage::DATA_POINT: return "Data point";
+	default: return "";
+	}
+}
+
+
+// ----------------------------------------------------------------------------
+// Histogram
+//
+//	Values below 2^SUB_BUCKET_BITS get a bucket each. Above that, each power of
+//	two is split into 2^(SUB_BUCKET_BITS - 1) buckets by the bits below the
+//	highest set bit.
+
+LogLatencyHistogram::LogLatencyHistogram() {
+	for (auto& bucket : buckets)
+		bucket.store(0, memory_order_relaxed);
+}
+
+void LogLatencyHistogram::Record(uint64_t nanoseconds) {
+	buckets[BucketIndex(nanoseconds)].fetch_add(1, memory_order_relaxed);
+	count.fetch_add(1, memory_order_relaxed);
+	sum.fetch_add(nanoseconds, memory_order_relaxed);
+
+	uint64_t currentMax = max.load(memory_order_relaxed);
+	while (nanoseconds > currentMax and !max.compare_exchange_weak(currentMax, nanoseconds, memory_order_relaxed)) {}
+}
+
+LogLatencySummary LogLatencyHistogram::Summarize() const {
+	LogLatencySummary summary;
+
+	// Buckets are read one by one while others may still record, so count
+	//   them here instead of trusting count to match
+	uint64_t counts[BUCKET_COUNT];
+	uint64_t total = 0;
+	for (size_t i = 0; i < BUCKET_COUNT; i++) {
+		counts[i] = buckets[i].load(memory_order_relaxed);
+		total += counts[i];
+	}
+	if (total == 0)
+		return summary;
+
+	double maxInUs = double(max.load(memory_order_relaxed)) / 1000.0;
+	summary.count = total;
+	summary.meanInUs = double(sum.load(memory_order_relaxed)) / double(count.load(memory_order_relaxed)) / 1000.0;
+	summary.maxInUs = maxInUs;
+
+	const double fractions[] = { 0.50, 0.90, 0.99, 0.999 };
+	double* targets[] = { &summary.p50InUs, &summary.p90InUs, &summary.p99InUs, &summary.p999InUs };
+	uint64_t seen = 0;
+	size_t next = 0;
+	for (size_t i = 0; i < BUCKET_COUNT and next < 4; i++) {
+		seen += counts[i];
+		while (next < 4 and double(seen) >= fractions[next] * double(total)) {
+			double value = double(BucketMidpoint(i)) / 1000.0;
+			*targets[next] = value < maxInUs ? value : maxInUs;
+			next++;
+		}
+	}
+	return summary;
+}
+
+void LogLatencyHistogram::Reset() {
+	for (auto& bucket : buckets)
+		bucket.store(0, memory_order_relaxed);
+	count.store(0, memory_order_relaxed);
+	sum.store(0, memory_order_relaxed);
+	max.store(0, memory_order_relaxed);
+}
+
+size_t LogLatencyHistogram::BucketIndex(uint64_t value) {
+	const uint64_t SUB_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;
+	if (value < SUB_BUCKET_COUNT)
+		return size_t(value);
+
+	unsigned int highestBit = 63;
+	while (!(value >> highestBit))
+		highestBit--;
+	unsigned int shift = highestBit - SUB_BUCKET_BITS + 1;
+	return size_t((uint64_t(shift) << (SUB_BUCKET_BITS - 1)) + (value >> shift));
+}
+
+uint64_t LogLatencyHistogram::BucketMidpoint(size_t index) {
+	const size_t HALF_SUB_BUCKET_COUNT = size_t(1) << (SUB_BUCKET_BITS - 1);
+	if (index < 2 * HALF_SUB_BUCKET_COUNT)
+		return uint64_t(index);
+
+	unsigned int shift = unsigned(index / HALF_SUB_BUCKET_COUNT - 1);
+	uint64_t subBucket = uint64_t(index - shift * HALF_SUB_BUCKET_COUNT);
+	return (subBucket << shift) + ((uint64_t(1) << shift) >> 1);
+}
+
+
+// ----------------------------------------------------------------------------
+// Stage timings
+
+void LogStageTimings::SetEnabled(const bool enable) {
+	enabled.store(enable, memory_order_relaxed);
+}
+
+bool LogStageTimings::IsEnabled() const {
+	return enabled.load(memory_order_relaxed);
+}
+
+void LogStageTimings::Record(const LogStage stage, uint64_t nanoseconds) {
+	histograms[size_t(stage)].Record(nanoseconds);
+}
+
+LogLatencySummary LogStageTimings::GetSummary(const LogStage stage) const {
+	return histograms[size_t(stage)].Summarize();
+}
+
+void LogStageTimings::Reset() {
+	for (auto& histogram : histograms)
+		histogram.Reset();
+}
+
+string LogStageTimings::FormatReport() const {
+	string report = "Stage latency in us (count p50/p99/max):";
+	bool first = true;
+	for (size_t i = 0; i < LOG_STAGE_COUNT; i++) {
+		LogLatencySummary summary = histograms[i].Summarize();
+		if (summary.count == 0)
+			continue;
+
+		char values[128];
+		snprintf(values, sizeof(values), " %llu %.1f/%.1f/%.1f", (unsigned long long)summary.count,
+			summary.p50InUs, summary.p99InUs, summary.maxInUs);
+		report += first ? " " : "; ";
+		report += GetLogStageName(LogStage(i));
+		report += values;
+		first = false;
+	}
+	return report;
+}
@@ -0,0 +1,138 @@
+/**
+* Log Stage Timings : Latency histograms for each stage of logging a data
+*	point, for finding out where the time goes when logging falls behind.
+*
+* - Histograms are HDR-style: values are counted in log-linear buckets (32 per
+*		power of two), so every recorded latency from nanoseconds to hours is
+*		kept within about 3% with a fixed 8 KB per stage.
+* - Recording is lock-free (relaxed atomic increments) and safe from any
+*		thread, e.g. the logging thread and the async writer's I/O thread at
+*		the same time.
+* - Timing is off by default. While it is off, a LogStageTimer does not read
+*		the clock.
+*
+* Example usage:
+*
+*	logger.SetStageTimingEnabled(true);
+*	...
+*	LogLatencySummary write = logger.GetStageLatency(LogStage::WRITE);
+*	if (write.p99InUs > 1000.0)
+*		...
+*
+*
+* @file LogStageTimings.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+
+enum class LogStage {
+	READ_VALUES,		// Reading the laser controller (CustomLogger)
+	FORMAT,				// Turning values into the text line
+	NOTIFY_OBSERVERS,	// Building the observer data and calling every observer
+	ENCRYPT,			// cryptofy(..)
+	MEMORY_LOG,			// Keeping the line in memory (and in the journal, if open)
+	WRITE,				// Writing the line to the output file, including waiting for it
+	DATA_POINT			// All of LoggerBase::LogDataPoint(..), or of one LogDataPoints(..) batch
+};
+
+const size_t LOG_STAGE_COUNT = 7;
+
+std::string GetLogStageName(const LogStage stage);
+
+
+struct LogLatencySummary {
+	std::uint64_t count = 0;
+	double meanInUs = 0.0;
+	double p50InUs = 0.0;
+	double p90InUs = 0.0;
+	double p99InUs = 0.0;
+	double p999InUs = 0.0;
+	double maxInUs = 0.0;
+};
+
+
+class LogLatencyHistogram {
+
+public:
+	LogLatencyHistogram();
+
+	LogLatencyHistogram(const LogLatencyHistogram&) = delete;
+	LogLatencyHistogram& operator=(const LogLatencyHistogram&) = delete;
+
+	void Record(std::uint64_t nanoseconds);
+	LogLatencySummary Summarize() const;
+	void Reset();
+
+
+private:
+	static const unsigned int SUB_BUCKET_BITS = 5;
+	static const size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 2) << (SUB_BUCKET_BITS - 1);
+
+	std::atomic<std::uint64_t> buckets[BUCKET_COUNT];
+	std::atomic<std::uint64_t> count{ 0 };
+	std::atomic<std::uint64_t> sum{ 0 };
+	std::atomic<std::uint64_t> max{ 0 };
+
+	static size_t BucketIndex(std::uint64_t value);
+	static std::uint64_t BucketMidpoint(size_t index);
+
+};
+
+
+class LogStageTimings {
+
+public:
+	void SetEnabled(const bool enable);
+	bool IsEnabled() const;
+
+	void Record(const LogStage stage, std::uint64_t nanoseconds);
+	LogLatencySummary GetSummary(const LogStage stage) const;
+	void Reset();
+
+	// One line with the count, p50, p99 and max of every stage recorded so far,
+	//   e.g. for a metadata line.
+	std::string FormatReport() const;
+
+
+private:
+	std::atomic<bool> enabled{ false };
+	LogLatencyHistogram histograms[LOG_STAGE_COUNT];
+
+};
+
+
+// Records the time from construction to destruction as one latency of a stage.
+class LogStageTimer {
+
+public:
+	LogStageTimer(LogStageTimings& _timings, const LogStage _stage)
+		: timings(_timings), stage(_stage), active(_timings.IsEnabled()) {
+		if (active)
+			start = std::chrono::steady_clock::now();
+	}
+
+	~LogStageTimer() {
+		if (active) {
+			auto elapsed = std::chrono::steady_clock::now() - start;
+			timings.Record(stage, std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+		}
+	}
+
+	LogStageTimer(const LogStageTimer&) = delete;
+	LogStageTimer& operator=(const LogStageTimer&) = delete;
+
+
+private:
+	LogStageTimings& timings;
+	LogStage stage;
+	bool active;
+	std::chrono::steady_clock::time_point start;
+
+};
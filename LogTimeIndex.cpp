@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#include "LogTimeIndex.h"
+
+using namespace std;
+
+
+const char LOG_TIME_INDEX_MAGIC[8] = { 'L', 'O', 'G', 'T', 'I', 'D', 'X', '1' };
+const uint64_t LOG_TIME_INDEX_ENTRY_SIZE = sizeof(int64_t) + sizeof(uint64_t);
+
+// The index and the Time column read the clock separately, so they can be a second apart
+const int64_t LOG_TIME_INDEX_CLOCK_SLACK_IN_SECONDS = 1;
+
+
+string MakeLogTimeIndexPath(const string& log_file_path) {
+	return filesystem::path(log_file_path).replace_extension(".tidx").string();
+}
+
+
+LogTimeIndexWriter::~LogTimeIndexWriter() {
+	Close();
+}
+
+bool LogTimeIndexWriter::Open(const string& file_path, uint64_t log_file_size) {
+	Close();
+
+	LogTimeIndex existing;
+	bool keepExisting = existing.Load(file_path)
+		and (existing.GetEntries().empty() or existing.GetEntries().back().offset < log_file_size);
+
+	if (keepExisting) {
+		// Cut off an entry torn by a crash
+		error_code ignored;
+		uint64_t intactSize = sizeof(LOG_TIME_INDEX_MAGIC) + existing.GetEntries().size() * LOG_TIME_INDEX_ENTRY_SIZE;
+		filesystem::resize_file(file_path, intactSize, ignored);
+		file = fopen(file_path.c_str(), "ab");
+		return file != nullptr;
+	}
+
+	file = fopen(file_path.c_str(), "wb");
+	if (file == nullptr)
+		return false;
+	if (fwrite(LOG_TIME_INDEX_MAGIC, 1, sizeof(LOG_TIME_INDEX_MAGIC), file) != sizeof(LOG_TIME_INDEX_MAGIC)
+		or fflush(file) != 0) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void LogTimeIndexWriter::Close() {
+	if (file != nullptr)
+		fclose(file);
+	file = nullptr;
+}
+
+bool LogTimeIndexWriter::IsOpen() const {
+	return file != nullptr;
+}
+
+bool LogTimeIndexWriter::Add(int64_t time, uint64_t offset) {
+	if (file == nullptr)
+		return false;
+	// Entries are rare, so each one goes straight to the operating system
+	return fwrite(&time, sizeof(time), 1, file) == 1
+		and fwrite(&offset, sizeof(offset), 1, file) == 1
+		and fflush(file) == 0;
+}
+
+
+bool LogTimeIndex::Load(const string& file_path) {
+	entries.clear();
+	FILE* file = fopen(file_path.c_str(), "rb");
+	if (file == nullptr)
+		return false;
+
+	char magic[sizeof(LOG_TIME_INDEX_MAGIC)];
+	if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) or memcmp(magic, LOG_TIME_INDEX_MAGIC, sizeof(magic)) != 0) {
+		fclose(file);
+		return false;
+	}
+
+	LogTimeIndexEntry entry;
+	while (fread(&entry.time, sizeof(entry.time), 1, file) == 1 and fread(&entry.offset, sizeof(entry.offset), 1, file) == 1)
+		entries.push_back(entry);
+	fclose(file);
+	return true;
+}
+
+const vector<LogTimeIndexEntry>& LogTimeIndex::GetEntries() const {
+	return entries;
+}
+
+bool LogTimeIndex::FindRange(time_t from_time, time_t to_time, uint64_t log_file_size,
+	uint64_t& begin, uint64_t& end) const {
+
+	if (entries.empty())
+		return false;
+
+	// Start at the last entry logged before the range: every line before it is older
+	int64_t from = int64_t(from_time) - LOG_TIME_INDEX_CLOCK_SLACK_IN_SECONDS;
+	auto first = partition_point(entries.begin(), entries.end(),
+		[from](const LogTimeIndexEntry& entry) { return entry.time < from; });
+	begin = first == entries.begin() ? first->offset : prev(first)->offset;
+
+	// End at the first entry logged after the range: every line from it on is newer
+	int64_t to = int64_t(to_time) + LOG_TIME_INDEX_CLOCK_SLACK_IN_SECONDS;
+	auto last = partition_point(entries.begin(), entries.end(),
+		[to](const LogTimeIndexEntry& entry) { return entry.time <= to; });
+	end = last == entries.end() ? log_file_size : last->offset;
+
+	begin = min(begin, log_file_size);
+	end = max(begin, min(end, log_file_size));
+	return true;
+}
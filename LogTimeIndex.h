@@ -0,0 +1,94 @@
+/**
+* Log Time Index : Sparse sidecar index from the time data points were logged
+*	to where they are in the log file, for reading a time range of a large
+*	log without scanning it from the start.
+*
+* - The logger adds an entry every N data points (see
+*		LoggerBase::SetTimeIndexInterval(..)) and for the first data point of
+*		every file: the second the data point was logged and the byte offset
+*		of its line.
+* - The index lives next to the log file (e.g. "myLog.tidx" for "myLog.log")
+*		and follows it when the log is rotated. Offsets always refer to the
+*		uncompressed text, also after a rotated segment has been compressed.
+* - FindRange(..) narrows a time range down to a byte range of the file. Since
+*		the index is sparse, the byte range can start and end up to N data
+*		points outside the requested times; filter on the Time column for exact
+*		bounds.
+* - Data points logged with explicit timestamps (LogDataPoints(..)) are not
+*		indexed, since their Time column is not the time they were logged.
+*
+* Index file layout:
+*	"LOGTIDX1", then per entry: i64 time (seconds since the epoch), u64 offset
+*
+*
+* @file LogTimeIndex.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+
+
+const size_t DEFAULT_LOG_TIME_INDEX_INTERVAL = 1024;
+
+
+struct LogTimeIndexEntry {
+	std::int64_t time = 0;
+	std::uint64_t offset = 0;
+};
+
+// Returns "<dir>/<stem>.tidx" for log_file_path.
+std::string MakeLogTimeIndexPath(const std::string& log_file_path);
+
+
+// Appends entries to an index file.
+class LogTimeIndexWriter {
+
+public:
+	LogTimeIndexWriter() = default;
+	~LogTimeIndexWriter();
+
+	LogTimeIndexWriter(const LogTimeIndexWriter&) = delete;
+	LogTimeIndexWriter& operator=(const LogTimeIndexWriter&) = delete;
+
+	// Open (or create) the index of a log file that currently holds
+	//   log_file_size bytes. An index that points past the end of the log
+	//   belongs to an older file and is started over.
+	bool Open(const std::string& file_path, std::uint64_t log_file_size);
+	void Close();
+	bool IsOpen() const;
+
+	// Entries must be added in the order the lines were written.
+	bool Add(std::int64_t time, std::uint64_t offset);
+
+
+private:
+	std::FILE* file = nullptr;
+
+};
+
+
+// Loads an index file for lookups.
+class LogTimeIndex {
+
+public:
+	bool Load(const std::string& file_path);
+
+	const std::vector<LogTimeIndexEntry>& GetEntries() const;
+
+	// Find the bytes of a log file of log_file_size bytes that hold every
+	//   indexed data point logged from from_time to to_time (inclusive).
+	//   Returns false if the index is empty.
+	bool FindRange(std::time_t from_time, std::time_t to_time, std::uint64_t log_file_size,
+		std::uint64_t& begin, std::uint64_t& end) const;
+
+
+private:
+	std::vector<LogTimeIndexEntry> entries;
+
+};
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "LogTimestampCache.h"
+#include "../CommonFunctions.h"
+
+using namespace std;
+
+
+const int MAX_TIMESTAMP_ATTEMPTS = 3;
+
+
+static void AppendSubsecondDigits(string& time, int64_t microseconds, unsigned int digits) {
+	digits = min(digits, MAX_LOG_SUBSECOND_DIGITS);
+	if (digits == 0)
+		return;
+
+	char text[MAX_LOG_SUBSECOND_DIGITS];
+	for (unsigned int i = MAX_LOG_SUBSECOND_DIGITS; i > 0; i--) {
+		text[i - 1] = char('0' + microseconds % 10);
+		microseconds /= 10;
+	}
+	time += '.';
+	time.append(text, digits);
+}
+
+
+LogTimestampCache& LogTimestampCache::Instance() {
+	static LogTimestampCache instance;
+	return instance;
+}
+
+void LogTimestampCache::Now(string& date, string& time, unsigned int subsecond_digits) {
+	int64_t second = 0;
+	int64_t microseconds = 0;
+
+	for (int attempt = 0; attempt < MAX_TIMESTAMP_ATTEMPTS; attempt++) {
+		auto sinceEpoch = chrono::system_clock::now().time_since_epoch();
+		second = chrono::duration_cast<chrono::seconds>(sinceEpoch).count();
+		microseconds = chrono::duration_cast<chrono::microseconds>(sinceEpoch).count() - second * 1000000;
+
+		if (TryRead(second, date, time) or Refresh(second, date, time)) {
+			AppendSubsecondDigits(time, microseconds, subsecond_digits);
+			return;
+		}
+	}
+
+	// The clock kept moving to the next second while formatting
+	date = GenerateDateString();
+	time = GenerateTimeString();
+	AppendSubsecondDigits(time, microseconds, subsecond_digits);
+}
+
+bool LogTimestampCache::TryRead(int64_t second, string& date, string& time) const {
+	uint64_t before = sequence.load(memory_order_acquire);
+	if (before % 2 != 0 or cachedSecond.load(memory_order_relaxed) != second)
+		return false;
+
+	bool loaded = cachedDate.Load(date) and cachedTime.Load(time);
+	atomic_thread_fence(memory_order_acquire);
+	return loaded and sequence.load(memory_order_relaxed) == before;
+}
+
+bool LogTimestampCache::Refresh(int64_t second, string& date, string& time) {
+	// Only one thread rewrites the cache, the others format for themselves
+	if (refreshing.exchange(true, memory_order_acquire))
+		return Generate(second, date, time);
+
+	bool generated = Generate(second, date, time);
+	if (generated and second > cachedSecond.load(memory_order_relaxed)) {
+		uint64_t current = sequence.load(memory_order_relaxed);
+		sequence.store(current + 1, memory_order_relaxed);
+		atomic_thread_fence(memory_order_release);
+
+		bool stored = cachedDate.Store(date) and cachedTime.Store(time);
+		cachedSecond.store(stored ? second : -1, memory_order_relaxed);
+
+		sequence.store(current + 2, memory_order_release);
+	}
+
+	refreshing.store(false, memory_order_release);
+	return generated;
+}
+
+bool LogTimestampCache::Generate(int64_t second, string& date, string& time) {
+	// The date is generated on both sides of the time so a midnight rollover
+	// between the two calls is detected instead of pairing the wrong day and time
+	date = GenerateDateString();
+	time = GenerateTimeString();
+	string dateAfter = GenerateDateString();
+	return date == dateAfter and int64_t(std::time(nullptr)) == second;
+}
+
+
+bool LogTimestampCache::CachedText::Store(const string& text) {
+	char bytes[sizeof(words)] = {};
+	if (text.size() >= sizeof(bytes))
+		return false;
+
+	bytes[0] = char(text.size());
+	memcpy(bytes + 1, text.data(), text.size());
+	for (size_t i = 0; i < TEXT_WORDS; i++) {
+		uint64_t word = 0;
+		memcpy(&word, bytes + i * sizeof(word), sizeof(word));
+		words[i].store(word, memory_order_relaxed);
+	}
+	return true;
+}
+
+bool LogTimestampCache::CachedText::Load(string& text) const {
+	char bytes[sizeof(words)];
+	for (size_t i = 0; i < TEXT_WORDS; i++) {
+		uint64_t word = words[i].load(memory_order_relaxed);
+		memcpy(bytes + i * sizeof(word), &word, sizeof(word));
+	}
+
+	size_t length = size_t(static_cast<unsigned char>(bytes[0]));
+	if (length >= sizeof(bytes))
+		return false;
+	text.assign(bytes + 1, length);
+	return true;
+}
@@ -0,0 +1,79 @@
+/**
+* Log Timestamp Cache : Process-wide cache of the date and time strings for
+*	the current second, shared by every logger.
+*
+* - The strings come from GenerateDateString() and GenerateTimeString(), so the
+*		format matches the rest of the application. They are only regenerated
+*		once per second, by whichever thread first notices the new second.
+* - Date and time are always taken from the same second, including across
+*		midnight.
+* - Reads never block. The cached strings are published with a sequence counter
+*		and copied out word by word. If the cache is being refreshed, or another
+*		thread is already refreshing it, the caller formats its own strings.
+* - Optionally appends up to 6 sub-second digits to the time string,
+*		e.g. "14:03:27.512" for 3 digits.
+*
+* Example usage:
+*
+*	std::string date, time;
+*	LogTimestampCache::Instance().Now(date, time, 3);
+*
+*
+* @file LogTimestampCache.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+
+const unsigned int MAX_LOG_SUBSECOND_DIGITS = 6;
+
+
+// Date and time column values of a data point.
+struct LogTimestamp {
+	std::string date;
+	std::string time;
+};
+
+
+class LogTimestampCache {
+
+public:
+	static LogTimestampCache& Instance();
+
+	LogTimestampCache(const LogTimestampCache&) = delete;
+	LogTimestampCache& operator=(const LogTimestampCache&) = delete;
+
+	// Set date and time to the current moment. subsecond_digits (0 to 6)
+	//   sub-second digits are appended to the time after a '.'.
+	void Now(std::string& date, std::string& time, unsigned int subsecond_digits = 0);
+
+
+private:
+	LogTimestampCache() = default;
+
+	static const size_t TEXT_WORDS = 4;	// Room for 31 characters plus length
+
+	// Text stored in atomic words so it can be copied while being rewritten
+	struct CachedText {
+		std::atomic<std::uint64_t> words[TEXT_WORDS] = {};
+		bool Store(const std::string& text);
+		bool Load(std::string& text) const;
+	};
+
+	std::atomic<std::uint64_t> sequence{ 0 };		// Odd while the cache is being rewritten
+	std::atomic<std::int64_t> cachedSecond{ -1 };
+	std::atomic<bool> refreshing{ false };
+	CachedText cachedDate;
+	CachedText cachedTime;
+
+	bool TryRead(std::int64_t second, std::string& date, std::string& time) const;
+	bool Refresh(std::int64_t second, std::string& date, std::string& time);
+	static bool Generate(std::int64_t second, std::string& date, std::string& time);
+
+};
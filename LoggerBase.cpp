@@ -1,6 +1,14 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
 #include <filesystem>
 
 #include "LoggerBase.h"
+#include "BufferedLogFile.h"
+#include "CompressedLogFile.h"
+#include "LogCompression.h"
+#include "MappedLogFile.h"
+#include "ParallelLogSaver.h"
 #include "../CommonFunctions.h"
 #include "../Security/DataDecryptor.h"
 #include "../ErrorMessageStream.h"
@@ -17,6 +25,13 @@ string GetMetadataLinePrefix() {
 	return ">>> ";
 }
 
+// 0 if the file does not exist (yet)
+static uint64_t GetFileSizeOrZero(const string& file_path) {
+	error_code ignored;
+	uintmax_t size = filesystem::file_size(file_path, ignored);
+	return size == uintmax_t(-1) ? 0 : uint64_t(size);
+}
+
 
 
 LoggerBase::LoggerBase() {
@@ -24,11 +39,27 @@ LoggerBase::LoggerBase() {
 	AddColumn("Time");
 }
 
+LoggerBase::~LoggerBase() {
+	CancelSave();
+	WaitForSave();
+	asyncWriter.reset();
+	CloseOutputFile();
+	{
+		lock_guard<mutex> lock(outputMutex);
+		columnarWriter.Close();
+	}
+	segmentFinalizer.reset();
+	CloseRollups();
+	CloseJournal();
+}
+
 
 //-------------------------------------------------------------------------
 // Default log output file
 
 void LoggerBase::SetFilePath(const string& file_path) {
+	WaitForAsyncWriter();
+	CloseRollups();
 	setFilePathSuccessful = false;
 
 	if (PathIsValid(file_path))
@@ -45,7 +76,20 @@ void LoggerBase::SetFilePath(const string& file_path) {
 	}
 	else {
 		e << "Failed to open log file: \"" << file_path << "\"." << endl;
+		return;
 	}
+
+	{
+		// Compressed files cut off their own torn blocks when opened
+		lock_guard<mutex> lock(journalMutex);
+		if (journal and writeMode != LogWriteMode::COMPRESSED and !TrimTornLogLine(filePath))
+			e << "Failed to check log file \"" << filePath << "\" for a partially written last line." << endl;
+	}
+
+	ResetSegment();
+
+	if (writeMode != LogWriteMode::OPEN_PER_LINE)
+		OpenOutputFile();
 }
 
 string LoggerBase::GetLogFilePath() const {
@@ -57,30 +101,305 @@ bool LoggerBase::SetFilePathSuccessful() const {
 }
 
 
+//-------------------------------------------------------------------------
+// Log output write mode
+
+void LoggerBase::SetWriteMode(const LogWriteMode mode) {
+	if (mode == writeMode)
+		return;
+	WaitForAsyncWriter();
+	CloseOutputFile();
+	writeMode = mode;
+
+	if (writeMode != LogWriteMode::OPEN_PER_LINE and setFilePathSuccessful)
+		OpenOutputFile();
+}
+
+LogWriteMode LoggerBase::GetWriteMode() const {
+	return writeMode;
+}
+
+void LoggerBase::SetFlushPolicy(const size_t max_buffered_bytes, const unsigned int max_buffer_age_in_ms) {
+	lock_guard<mutex> lock(outputMutex);
+	outputPolicy.maxBufferedBytes = max_buffered_bytes;
+	outputPolicy.maxBufferAgeInMs = max_buffer_age_in_ms;
+	if (outputFile)
+		outputFile->SetPolicy(outputPolicy);
+}
+
+void LoggerBase::Flush() {
+	WaitForAsyncWriter();
+	lock_guard<mutex> lock(outputMutex);
+	if (columnarWriter.IsOpen())
+		columnarWriter.FlushChunk();
+	if (!outputFile)
+		return;
+
+	bool success = outputPolicy.durabilityMode == LogDurabilityMode::OS_BUFFERED ?
+		outputFile->Flush() : outputFile->Commit();
+	if (!success)
+		e << "Failed to flush log file \"" << filePath << "\"" << endl;
+}
+
+void LoggerBase::FlushIfDue() {
+	{
+		lock_guard<mutex> lock(outputMutex);
+		if (outputFile and !outputFile->FlushIfDue())
+			e << "Failed to flush log file \"" << filePath << "\"" << endl;
+	}
+	lock_guard<mutex> lock(journalMutex);
+	if (journal and !journal->FlushIfDue())
+		e << "Failed to flush log journal \"" << journal->GetFilePath() << "\"." << endl;
+}
+
+void LoggerBase::SetDurabilityPolicy(const LogDurabilityMode mode, const unsigned int group_commit_lines, const unsigned int group_commit_interval_in_ms) {
+	lock_guard<mutex> lock(outputMutex);
+	outputPolicy.durabilityMode = mode;
+	outputPolicy.groupCommitLines = group_commit_lines;
+	outputPolicy.groupCommitIntervalInMs = group_commit_interval_in_ms;
+	if (outputFile)
+		outputFile->SetPolicy(outputPolicy);
+}
+
+LogDurabilityMode LoggerBase::GetDurabilityMode() const {
+	lock_guard<mutex> lock(outputMutex);
+	return outputPolicy.durabilityMode;
+}
+
+LogCommitLatencyStats LoggerBase::GetCommitLatencyStats() const {
+	lock_guard<mutex> lock(outputMutex);
+	return outputFile ? outputFile->GetCommitLatencyStats() : LogCommitLatencyStats();
+}
+
+
+//-------------------------------------------------------------------------
+// Asynchronous output
+
+void LoggerBase::SetAsyncWriting(const bool enable, const size_t queue_capacity, const LogQueueFullPolicy policy) {
+	// Destroying the writer drains its queue first
+	asyncWriter.reset();
+	if (!enable)
+		return;
+
+	asyncWriter = make_unique<AsyncLogWriter>(
+		[this](PendingLogLine& pending) {
+			if (pending.rotate) {
+				RotateOutputFile();
+				if (pending.line.empty())
+					return;
+			}
+			if (pending.encrypt)
+				WriteLineToOutput(EncryptLine(pending.line), 1, pending.indexTime);
+			else
+				WriteLineToOutput(move(pending.line), pending.lineCount, pending.indexTime);
+		},
+		[this]() {
+			FlushIfDue();
+		},
+		queue_capacity, policy);
+}
+
+bool LoggerBase::IsAsyncWriting() const {
+	return asyncWriter != nullptr;
+}
+
+size_t LoggerBase::GetWriteQueueDepth() const {
+	return asyncWriter ? asyncWriter->GetQueueDepth() : 0;
+}
+
+size_t LoggerBase::GetPeakWriteQueueDepth() const {
+	return asyncWriter ? asyncWriter->GetPeakQueueDepth() : 0;
+}
+
+unsigned long long LoggerBase::GetDroppedLineCount() const {
+	return asyncWriter ? asyncWriter->GetDroppedLineCount() : 0;
+}
+
+
+//-------------------------------------------------------------------------
+// Log rotation
+
+void LoggerBase::SetRotationPolicy(const LogRotationPolicy& policy) {
+	rotationPolicy = policy;
+	nextRotationTime = GetNextLogRotationTime(rotationPolicy.boundary, std::time(nullptr));
+	if (rotationPolicy.IsEnabled() and !segmentFinalizer)
+		segmentFinalizer = make_unique<LogSegmentFinalizer>();
+}
+
+LogRotationPolicy LoggerBase::GetRotationPolicy() const {
+	return rotationPolicy;
+}
+
+void LoggerBase::RotateLogFile() {
+	if (!setFilePathSuccessful)
+		return;
+	StartNewSegment();
+}
+
+void LoggerBase::WaitForSegmentFinalization() {
+	WaitForAsyncWriter();
+	if (segmentFinalizer)
+		segmentFinalizer->WaitUntilIdle();
+}
+
+size_t LoggerBase::GetFinalizedSegmentCount() const {
+	return segmentFinalizer ? segmentFinalizer->GetFinalizedSegmentCount() : 0;
+}
+
+
+//-------------------------------------------------------------------------
+// Time index
+
+void LoggerBase::SetTimeIndexInterval(const size_t interval_rows) {
+	timeIndexInterval = interval_rows;
+}
+
+size_t LoggerBase::GetTimeIndexInterval() const {
+	return timeIndexInterval;
+}
+
+
+//-------------------------------------------------------------------------
+// Rollups
+
+void LoggerBase::SetRollupIntervals(const vector<unsigned int>& bucket_seconds) {
+	CloseRollups();
+	rollupIntervals = bucket_seconds;
+}
+
+vector<unsigned int> LoggerBase::GetRollupIntervals() const {
+	return rollupIntervals;
+}
+
+
 //-------------------------------------------------------------------------
 // Saving log contents to new file at any time
 
-void LoggerBase::SaveMemoryLogToFile(const string& file_path) {
-	SaveMemoryLogToFileHelper(file_path, false);
+void LoggerBase::SaveMemoryLogToFile(const string& file_path, const LogSaveProgressCallback& on_progress) {
+	SaveMemoryLogToFileHelper(file_path, false, on_progress);
 }
 
-void LoggerBase::SaveMemoryLogToFileEncrypted(const string& file_path) {
-	SaveMemoryLogToFileHelper(file_path, true);
+void LoggerBase::SaveMemoryLogToFileEncrypted(const string& file_path, const LogSaveProgressCallback& on_progress) {
+	SaveMemoryLogToFileHelper(file_path, true, on_progress);
 }
 
 bool LoggerBase::SaveSuccessful() const {
 	return saveToFileSuccessful;
 }
 
+bool LoggerBase::StartSavingMemoryLogToFile(const string& file_path, const bool encrypt) {
+	if (!PathIsValid(file_path)) {
+		e << "Invalid file path: \"" << file_path << "\"." << endl;
+		return false;
+	}
+	{
+		lock_guard<mutex> lock(saveStatusMutex);
+		if (saveStatus.running) {
+			e << "Cannot save to \"" << file_path << "\" while another save is running." << endl;
+			return false;
+		}
+	}
+	if (saveThread.joinable())
+		saveThread.join();
+
+	LogHistory::Snapshot snapshot = logDataInMemory.TakeSnapshot();
+	{
+		lock_guard<mutex> lock(saveStatusMutex);
+		saveStatus = LogSaveStatus();
+		saveStatus.running = true;
+		saveStatus.totalLines = snapshot.GetLineCount();
+	}
+	saveCancelRequested = false;
+
+	saveThread = thread([this, file_path, encrypt, snapshot = move(snapshot)]() {
+		bool succeeded = SaveSnapshotToFile(snapshot, file_path, encrypt,
+			[this](size_t lines_saved, size_t) {
+				lock_guard<mutex> lock(saveStatusMutex);
+				saveStatus.linesSaved = lines_saved;
+			},
+			&saveCancelRequested);
+
+		lock_guard<mutex> lock(saveStatusMutex);
+		saveStatus.running = false;
+		saveStatus.succeeded = succeeded;
+		saveStatus.canceled = !succeeded and saveCancelRequested;
+	});
+	return true;
+}
+
+LogSaveStatus LoggerBase::GetSaveStatus() const {
+	lock_guard<mutex> lock(saveStatusMutex);
+	return saveStatus;
+}
+
+void LoggerBase::CancelSave() {
+	saveCancelRequested = true;
+}
+
+void LoggerBase::WaitForSave() {
+	if (saveThread.joinable())
+		saveThread.join();
+}
+
+void LoggerBase::SetMemoryLogLimit(const size_t max_bytes, const size_t max_lines) {
+	logDataInMemory.SetMemoryLimit(max_bytes, max_lines);
+}
+
+
+//-------------------------------------------------------------------------
+// Crash recovery
+
+size_t LoggerBase::OpenJournal(const string& journal_path, const LogOutputPolicy& policy) {
+	if (!PathIsValid(journal_path)) {
+		e << "Invalid file path: \"" << journal_path << "\"." << endl;
+		return 0;
+	}
+
+	lock_guard<mutex> lock(journalMutex);
+	journal.reset();
+	auto newJournal = make_unique<LogJournal>();
+	newJournal->SetPolicy(policy);
+	if (!newJournal->Open(journal_path)) {
+		e << "Failed to open log journal: \"" << journal_path << "\"." << endl;
+		return 0;
+	}
+
+	const LogJournalRecovery& recovery = newJournal->GetRecovery();
+	if (recovery.truncated)
+		e << "Cut off a torn or corrupt record at the end of log journal \"" << journal_path << "\"." << endl;
+	logDataInMemory.RestoreFromJournal(journal_path, recovery);
+	journal = move(newJournal);
+	return recovery.records;
+}
+
+void LoggerBase::CloseJournal() {
+	lock_guard<mutex> lock(journalMutex);
+	if (journal and !journal->CloseCleanly())
+		e << "Failed to close log journal \"" << journal->GetFilePath() << "\"." << endl;
+	journal.reset();
+}
+
 
 //-------------------------------------------------------------------------
 // Logging structured data
 
-void LoggerBase::AddColumn(const string& columnName) {
+void LoggerBase::AddColumn(const string& columnName, const LogColumnType type, const int precision,
+	const string& category, const string& unit) {
+	CloseRollups();
 	columnNames.push_back(columnName);
+	columnFormats.push_back({ type, precision });
+	columnCategories.push_back(category);
+	columnUnits.push_back(unit);
+	schemaChanged = true;
 }
 
 void LoggerBase::WriteHeaderLine() {
+	if (!columnarFilePath.empty())
+		OpenColumnarOutput();
+	if (typedMemoryLogEnabled)
+		typedMemoryLog.Start(MakeColumnarSchema(), typedMemoryLogRowsPerChunk);
+	PublishSchema();
+
 	string header = "";
 	for (string columnName : columnNames)
 		header += columnName + ",";
@@ -89,6 +408,9 @@ void LoggerBase::WriteHeaderLine() {
 	if (header.length() > 1)
 		header[header.length() - 1] = ' ';
 
+	// Written again at the top of every new segment
+	headerLine = header;
+
 	if (encryptData)
 		CommitLineEncrypt(header);
 	else
@@ -102,34 +424,76 @@ void LoggerBase::LogDataPoint(const vector<string>& values) {
 		return;
 	}
 
-	string date = GenerateDateString();
-	string time = GenerateTimeString();
+	ReportStageTimingsIfDue();
+	LogStageTimer timer(stageTimings, LogStage::DATA_POINT);
+	RotateIfDue(1);
+
+	// Date and time come from the shared per-second cache, taken from one clock reading
+	string date, time;
+	LogTimestampCache::Instance().Now(date, time, subsecondDigits);
 
 	// Notify all subscribed observers with data to be logged
-	map<string, string> dataForObservers;
-	dataForObservers["Date"] = date;
-	dataForObservers["Time"] = time;
-	for (size_t col = 2; col < columnNames.size(); col++) {
-		dataForObservers[columnNames[col]] = values[col - 2];
+	if (hasObservers()) {
+		LogStageTimer observerTimer(stageTimings, LogStage::NOTIFY_OBSERVERS);
+		map<string, string> dataForObservers;
+		dataForObservers["Date"] = date;
+		dataForObservers["Time"] = time;
+		for (size_t col = 2; col < columnNames.size(); col++) {
+			dataForObservers[columnNames[col]] = values[col - 2];
+		}
+		dataPointLogged(dataForObservers);
+	}
+	if (hasFilteredObservers()) {
+		LogStageTimer observerTimer(stageTimings, LogStage::NOTIFY_OBSERVERS);
+		PublishSchemaIfChanged();
+		filteredDataPointLogged([&](const LogSchema& columns) {
+			map<string, string> dataForObserver;
+			for (const LogColumnInfo& column : columns.GetColumns()) {
+				if (column.id >= 2)
+					dataForObserver[column.name] = values[column.id - 2];
+				else
+					dataForObserver[column.name] = column.id == LOG_DATE_COLUMN_ID ? date : time;
+			}
+			return dataForObserver;
+		});
+	}
+	if (hasTypedObservers()) {
+		LogStageTimer observerTimer(stageTimings, LogStage::NOTIFY_OBSERVERS);
+		NotifyTypedObservers(date, time, values);
 	}
-	dataPointLogged(dataForObservers);
 
 
 	string line = "";
+	{
+		LogStageTimer formatTimer(stageTimings, LogStage::FORMAT);
+		line += date + ",";
+		line += time + ",";
 
-	line += date + ",";
-	line += time + ",";
+		for (const string& value : values) {
+			line += value;
+			line += ',';
+		}
 
-	for (string value : values)
-		line += value + ",";
+		if (line.length() > 0)
+			line[line.length() - 1] = ' ';
+	}
 
-	if (line.length() > 0)
-		line[line.length() - 1] = ' ';
+	CommitDataPointLine(line);
+	AddToRollups(values);
 
-	if (encryptData)
-		CommitLineEncrypt(line);
-	else
-		CommitLine(line);
+	if (columnarWriter.IsOpen() or typedMemoryLog.IsStarted()) {
+		vector<string> row;
+		row.reserve(columnNames.size());
+		row.push_back(date);
+		row.push_back(time);
+		row.insert(row.end(), values.begin(), values.end());
+
+		lock_guard<mutex> lock(outputMutex);
+		if (columnarWriter.IsOpen() and !columnarWriter.AppendRow(row))
+			e << "Failed to write data point to columnar file \"" << columnarFilePath << "\"" << endl;
+		if (typedMemoryLog.IsStarted())
+			typedMemoryLog.AppendRow(row);
+	}
 
 
 
@@ -156,23 +520,227 @@ void LoggerBase::LogDataPoint(const vector<string>& values) {
 }
 
 
+void LoggerBase::LogDataPoint(const LogRow& values) {
+
+	if (values.Size() != columnNames.size() - 2) {
+		e << "ERROR - Logging function: Number of values to write does not match number of columns." << endl;
+		return;
+	}
+
+	ReportStageTimingsIfDue();
+	LogStageTimer timer(stageTimings, LogStage::DATA_POINT);
+	RotateIfDue(1);
+
+	string date, time;
+	LogTimestampCache::Instance().Now(date, time, subsecondDigits);
+
+	// Map observers still receive text, so only format for them if there are any
+	if (hasObservers()) {
+		LogStageTimer observerTimer(stageTimings, LogStage::NOTIFY_OBSERVERS);
+		dataPointLogged(MakeObserverData(date, time, values));
+	}
+	if (hasFilteredObservers()) {
+		LogStageTimer observerTimer(stageTimings, LogStage::NOTIFY_OBSERVERS);
+		PublishSchemaIfChanged();
+		filteredDataPointLogged([&](const LogSchema& columns) { return MakeObserverData(date, time, values, columns); });
+	}
+	if (hasTypedObservers()) {
+		LogStageTimer observerTimer(stageTimings, LogStage::NOTIFY_OBSERVERS);
+		NotifyTypedObservers(date, time, values);
+	}
+
+	{
+		LogStageTimer formatTimer(stageTimings, LogStage::FORMAT);
+		FormatDataPoint(date, time, values, formattedLine);
+	}
+	CommitDataPointLine(formattedLine);
+	AddToRollups(values);
+
+	if (columnarWriter.IsOpen() or typedMemoryLog.IsStarted()) {
+		lock_guard<mutex> lock(outputMutex);
+		AppendColumnarRow(date, time, values);
+	}
+}
+
+void LoggerBase::LogDataPoints(const vector<LogRow>& rows, const vector<LogTimestamp>& timestamps) {
+	if (rows.empty())
+		return;
+
+	if (!timestamps.empty() and timestamps.size() != rows.size()) {
+		e << "ERROR - Logging function: Number of timestamps does not match number of data points." << endl;
+		return;
+	}
+	for (const LogRow& values : rows) {
+		if (values.Size() != columnNames.size() - 2) {
+			e << "ERROR - Logging function: Number of values to write does not match number of columns." << endl;
+			return;
+		}
+	}
+
+	ReportStageTimingsIfDue();
+	LogStageTimer timer(stageTimings, LogStage::DATA_POINT);
+	RotateIfDue(rows.size());
+
+	LogTimestamp now;
+	if (timestamps.empty())
+		LogTimestampCache::Instance().Now(now.date, now.time, subsecondDigits);
+
+	if (hasObservers()) {
+		LogStageTimer observerTimer(stageTimings, LogStage::NOTIFY_OBSERVERS);
+		vector<map<string, string>> dataForObservers;
+		dataForObservers.reserve(rows.size());
+		for (size_t row = 0; row < rows.size(); row++) {
+			const LogTimestamp& timestamp = timestamps.empty() ? now : timestamps[row];
+			dataForObservers.push_back(MakeObserverData(timestamp.date, timestamp.time, rows[row]));
+		}
+		dataPointsLogged(dataForObservers);
+	}
+	if (hasFilteredObservers()) {
+		LogStageTimer observerTimer(stageTimings, LogStage::NOTIFY_OBSERVERS);
+		PublishSchemaIfChanged();
+		filteredDataPointsLogged(rows.size(), [&](size_t row, const LogSchema& columns) {
+			const LogTimestamp& timestamp = timestamps.empty() ? now : timestamps[row];
+			return MakeObserverData(timestamp.date, timestamp.time, rows[row], columns);
+		});
+	}
+	if (hasTypedObservers()) {
+		LogStageTimer observerTimer(stageTimings, LogStage::NOTIFY_OBSERVERS);
+		for (size_t row = 0; row < rows.size(); row++) {
+			const LogTimestamp& timestamp = timestamps.empty() ? now : timestamps[row];
+			NotifyTypedObservers(timestamp.date, timestamp.time, rows[row]);
+		}
+	}
+
+	// Every line is kept in memory on its own, but goes to the file as one block
+	formattedBatch.clear();
+	for (size_t row = 0; row < rows.size(); row++) {
+		const LogTimestamp& timestamp = timestamps.empty() ? now : timestamps[row];
+		{
+			LogStageTimer formatTimer(stageTimings, LogStage::FORMAT);
+			FormatDataPoint(timestamp.date, timestamp.time, rows[row], formattedLine);
+		}
+		AppendToHistory(formattedLine);
+
+		if (encryptData)
+			formattedBatch += EncryptLine(formattedLine);
+		else
+			formattedBatch += formattedLine;
+		formattedBatch += '\n';
+	}
+	// Rows with explicit timestamps were not logged now, so they are not indexed or rolled up
+	WriteLineToFile(formattedBatch, rows.size(), timestamps.empty() ? TakeTimeIndexTime(rows.size()) : 0);
+	if (timestamps.empty()) {
+		for (const LogRow& values : rows)
+			AddToRollups(values);
+	}
+
+	if (columnarWriter.IsOpen() or typedMemoryLog.IsStarted()) {
+		lock_guard<mutex> lock(outputMutex);
+		for (size_t row = 0; row < rows.size(); row++) {
+			const LogTimestamp& timestamp = timestamps.empty() ? now : timestamps[row];
+			AppendColumnarRow(timestamp.date, timestamp.time, rows[row]);
+		}
+	}
+}
+
+void LoggerBase::SetSubsecondDigits(const unsigned int digits) {
+	subsecondDigits = min(digits, MAX_LOG_SUBSECOND_DIGITS);
+}
+
+unsigned int LoggerBase::GetSubsecondDigits() const {
+	return subsecondDigits;
+}
+
+
+//-------------------------------------------------------------------------
+// Columnar binary output
+
+void LoggerBase::SetColumnarOutputFilePath(const string& file_path, const size_t rows_per_chunk) {
+	if (!file_path.empty() and !PathIsValid(file_path)) {
+		e << "Invalid file path: \"" << file_path << "\"." << endl;
+		return;
+	}
+
+	lock_guard<mutex> lock(outputMutex);
+	columnarWriter.Close();
+	columnarFilePath = file_path;
+	columnarRowsPerChunk = rows_per_chunk;
+}
+
+string LoggerBase::GetColumnarOutputFilePath() const {
+	return columnarFilePath;
+}
+
+void LoggerBase::SetTypedMemoryLog(const bool enable, const size_t rows_per_chunk) {
+	lock_guard<mutex> lock(outputMutex);
+	typedMemoryLogEnabled = enable;
+	typedMemoryLogRowsPerChunk = rows_per_chunk;
+	if (enable and !headerLine.empty())
+		typedMemoryLog.Start(MakeColumnarSchema(), typedMemoryLogRowsPerChunk);
+	else if (!enable)
+		typedMemoryLog.Clear();
+}
+
+bool LoggerBase::GetTypedMemoryLog() const {
+	return typedMemoryLogEnabled;
+}
+
+bool LoggerBase::ReadTypedMemoryLog(const vector<string>& column_names, vector<ColumnarColumnData>& columns) const {
+	return typedMemoryLog.ReadColumns(column_names, columns);
+}
+
+size_t LoggerBase::GetTypedMemoryLogBytes() const {
+	return typedMemoryLog.GetBytesInMemory();
+}
+
+
+//-------------------------------------------------------------------------
+// Pipeline timing
+
+void LoggerBase::SetStageTimingEnabled(const bool enable) {
+	stageTimings.SetEnabled(enable);
+	nextStageTimingReport = 0;
+}
+
+bool LoggerBase::GetStageTimingEnabled() const {
+	return stageTimings.IsEnabled();
+}
+
+LogLatencySummary LoggerBase::GetStageLatency(const LogStage stage) const {
+	return stageTimings.GetSummary(stage);
+}
+
+void LoggerBase::ResetStageLatencies() {
+	stageTimings.Reset();
+}
+
+void LoggerBase::SetStageTimingReportInterval(const unsigned int interval_in_s) {
+	stageTimingReportInterval = interval_in_s;
+	nextStageTimingReport = 0;
+}
+
+unsigned int LoggerBase::GetStageTimingReportInterval() const {
+	return stageTimingReportInterval;
+}
+
+
 //-------------------------------------------------------------------------
 // Logging custom data
 
 void LoggerBase::CommitLine(string line) {
-	logDataInMemory.push_back(line);
-	WriteLineToFile(line);
+	AppendToHistory(line);
+	WriteLineToFile(move(line));
 }
 
 void LoggerBase::CommitLineEncrypt(string line) {
-	logDataInMemory.push_back(line);
-	WriteEncryptedLineToFile(line);
+	AppendToHistory(line);
+	WriteEncryptedLineToFile(move(line));
 }
 
 void LoggerBase::CommitLineMetadata(string line) {
 	line = GetMetadataLinePrefix() + line;
-	logDataInMemory.push_back(line);
-	WriteLineToFile(line);
+	AppendToHistory(line);
+	WriteLineToFile(move(line));
 }
 
 
@@ -183,58 +751,585 @@ string LoggerBase::AppendNewLineIfNecessary(string line) {
 	if (line == "")
 		return "";
 	if (line.back() != '\n')
-		line = line + '\n';
+		line += '\n';
 	return line;
 }
 
-void LoggerBase::WriteLineToFile(string line) {
+void LoggerBase::AppendToHistory(const string& line) {
+	LogStageTimer timer(stageTimings, LogStage::MEMORY_LOG);
+	logDataInMemory.Append(line);
+
+	// The journal stores lines as plain text
+	if (encryptData)
+		return;
+	lock_guard<mutex> lock(journalMutex);
+	if (journal and !journal->Write(line))
+		e << "Failed to write to log journal \"" << journal->GetFilePath() << "\"." << endl;
+}
+
+void LoggerBase::ReportStageTimingsIfDue() {
+	if (stageTimingReportInterval == 0 or !stageTimings.IsEnabled())
+		return;
+
+	// The first interval starts with the first data point
+	time_t now = std::time(nullptr);
+	if (nextStageTimingReport == 0)
+		nextStageTimingReport = now + stageTimingReportInterval;
+	else if (now >= nextStageTimingReport) {
+		nextStageTimingReport = now + stageTimingReportInterval;
+		CommitLineMetadata(stageTimings.FormatReport());
+	}
+}
+
+void LoggerBase::ResetJournal() {
+	lock_guard<mutex> lock(journalMutex);
+	if (!journal)
+		return;
+
+	string journalPath = journal->GetFilePath();
+	journal->Close();
+	error_code ignored;
+	filesystem::remove(journalPath, ignored);
+	if (!journal->Open(journalPath)) {
+		e << "Failed to open log journal: \"" << journalPath << "\"." << endl;
+		journal.reset();
+	}
+}
+
+void LoggerBase::CommitDataPointLine(const string& line) {
+	AppendToHistory(line);
+	int64_t indexTime = TakeTimeIndexTime(1);
+	if (encryptData)
+		WriteEncryptedLineToFile(line, indexTime);
+	else
+		WriteLineToFile(line, 1, indexTime);
+}
+
+void LoggerBase::WriteLineToFile(string line, const size_t line_count, const int64_t index_time) {
+	if (asyncWriter) {
+		asyncWriter->Enqueue({ move(line), false, line_count, false, index_time });
+		return;
+	}
+	WriteLineToOutput(move(line), line_count, index_time);
+}
+
+void LoggerBase::WriteLineToOutput(string line, const size_t line_count, const int64_t index_time) {
+	LogStageTimer timer(stageTimings, LogStage::WRITE);
+	lock_guard<mutex> lock(outputMutex);
+	AddTimeIndexEntry(index_time);
+
+	if (writeMode != LogWriteMode::OPEN_PER_LINE) {
+		line = AppendNewLineIfNecessary(move(line));
+		outputOffset += line.size();
+		if (!outputFile or !outputFile->Write(line, line_count))
+			e << "Failed to commit line \"" << line << "\" to file \"" << filePath << "\"" << endl;
+		CheckSegmentSize();
+		return;
+	}
+
 	logFile.open(filePath, ios::app);
 	if (logFile.is_open()) {
 		line = AppendNewLineIfNecessary(line);
 		logFile << line;
+		// The stream may translate line endings, so ask it where the file ends
+		streamoff fileEnd = logFile.tellp();
+		outputOffset = fileEnd >= 0 ? uint64_t(fileEnd) : outputOffset + line.size();
 		logFile.close();
 	}
 	else {
 		e << "Failed to commit line \"" << line << "\" to file \"" << filePath << "\"" << endl;
 	}
+	CheckSegmentSize();
+}
+
+void LoggerBase::FormatDataPoint(const string& date, const string& time, const LogRow& values, string& line) const {
+	line.clear();
+	line += date;
+	line += ',';
+	line += time;
+	for (size_t i = 0; i < values.Size(); i++) {
+		line += ',';
+		values.AppendFormatted(i, columnFormats[i + 2].precision, line);
+	}
+	line += ' ';
+}
+
+map<string, string> LoggerBase::MakeObserverData(const string& date, const string& time, const LogRow& values) const {
+	map<string, string> dataForObservers;
+	dataForObservers["Date"] = date;
+	dataForObservers["Time"] = time;
+	for (size_t col = 2; col < columnNames.size(); col++) {
+		values.AppendFormatted(col - 2, columnFormats[col].precision, dataForObservers[columnNames[col]]);
+	}
+	return dataForObservers;
+}
+
+map<string, string> LoggerBase::MakeObserverData(const string& date, const string& time, const LogRow& values,
+	const LogSchema& columns) const {
+	map<string, string> dataForObserver;
+	for (const LogColumnInfo& column : columns.GetColumns()) {
+		string& value = dataForObserver[column.name];
+		if (column.id >= 2)
+			values.AppendFormatted(column.id - 2, column.format.precision, value);
+		else
+			value = column.id == LOG_DATE_COLUMN_ID ? date : time;
+	}
+	return dataForObserver;
+}
+
+void LoggerBase::PublishSchema() {
+	vector<LogColumnInfo> columns;
+	columns.reserve(columnNames.size());
+	for (size_t col = 0; col < columnNames.size(); col++) {
+		LogColumnInfo column;
+		column.id = col;
+		column.name = columnNames[col];
+		column.category = col < columnCategories.size() ? columnCategories[col] : "";
+		column.unit = col < columnUnits.size() ? columnUnits[col] : "";
+		column.format = columnFormats[col];
+		columns.push_back(move(column));
+	}
+	schemaPublished(make_shared<const LogSchema>(move(columns)));
+	schemaChanged = false;
+}
+
+void LoggerBase::PublishSchemaIfChanged() {
+	// Columns added since the header line was written are not in the schema yet
+	if (schemaChanged or !publishedSchema)
+		PublishSchema();
+}
+
+void LoggerBase::NotifyTypedObservers(const string& date, const string& time, const LogRow& values) {
+	PublishSchemaIfChanged();
+
+	// One pooled buffer shared by every observer; it comes back once they all let go
+	LogDataPointRef dataPoint = dataPointPool->Make([&](LogDataPointEvent& event) {
+		event.schema = publishedSchema;
+		event.values.AddString(date);
+		event.values.AddString(time);
+		event.values.Append(values);
+	});
+	typedDataPointLogged(dataPoint);
+}
+
+void LoggerBase::NotifyTypedObservers(const string& date, const string& time, const vector<string>& values) {
+	PublishSchemaIfChanged();
+
+	// Parsed once here rather than once per observer; text that does not parse stays text
+	LogDataPointRef dataPoint = dataPointPool->Make([&](LogDataPointEvent& event) {
+		event.schema = publishedSchema;
+		event.values.AddString(date);
+		event.values.AddString(time);
+		for (size_t i = 0; i < values.size(); i++) {
+			const string& text = values[i];
+			const char* end = text.data() + text.size();
+			LogColumnType type = columnFormats[i + 2].type;
+			if (type == LogColumnType::FLOAT) {
+				float value;
+				auto parsed = from_chars(text.data(), end, value);
+				if (parsed.ec == errc() and parsed.ptr == end) {
+					event.values.AddFloat(value);
+					continue;
+				}
+			}
+			else if (type == LogColumnType::INT) {
+				int64_t value;
+				auto parsed = from_chars(text.data(), end, value);
+				if (parsed.ec == errc() and parsed.ptr == end) {
+					event.values.AddInt(value);
+					continue;
+				}
+			}
+			event.values.AddString(text);
+		}
+	});
+	typedDataPointLogged(dataPoint);
 }
 
-void LoggerBase::WriteEncryptedLineToFile(string line) {
-	line = GetEncryptedLinePrefix() + cryptofy(line);
-	WriteLineToFile(line);
+void LoggerBase::AppendColumnarRow(const string& date, const string& time, const LogRow& values) {
+	// Caller holds outputMutex
+	columnarRow.Clear();
+	columnarRow.AddString(date);
+	columnarRow.AddString(time);
+	columnarRow.Append(values);
+	if (columnarWriter.IsOpen() and !columnarWriter.AppendRow(columnarRow))
+		e << "Failed to write data point to columnar file \"" << columnarFilePath << "\"" << endl;
+	if (typedMemoryLog.IsStarted())
+		typedMemoryLog.AppendRow(columnarRow);
 }
 
-void LoggerBase::SaveMemoryLogToFileHelper(const string& file_path, bool encrypt) {
+vector<ColumnarColumnInfo> LoggerBase::MakeColumnarSchema() const {
+	vector<ColumnarColumnInfo> schema;
+	for (size_t col = 0; col < columnNames.size(); col++)
+		schema.push_back({ columnNames[col], columnFormats[col].type });
+	return schema;
+}
+
+void LoggerBase::OpenColumnarOutput() {
+	// The columnar file is not encrypted
+	if (encryptData)
+		return;
+	vector<ColumnarColumnInfo> schema = MakeColumnarSchema();
+
+	lock_guard<mutex> lock(outputMutex);
+	if (!columnarWriter.Open(columnarFilePath, schema, columnarRowsPerChunk))
+		e << "Failed to open columnar log file: \"" << columnarFilePath << "\"." << endl;
+}
+
+void LoggerBase::OpenOutputFile() {
+	lock_guard<mutex> lock(outputMutex);
+	if (writeMode == LogWriteMode::MEMORY_MAPPED)
+		outputFile = make_unique<MappedLogFile>();
+	else if (writeMode == LogWriteMode::COMPRESSED)
+		outputFile = make_unique<CompressedLogFile>();
+	else
+		outputFile = make_unique<BufferedLogFile>();
+	outputFile->SetPolicy(outputPolicy);
+
+	if (!outputFile->Open(filePath)) {
+		e << "Failed to open log file: \"" << filePath << "\"." << endl;
+		outputFile.reset();
+		setFilePathSuccessful = false;
+		return;
+	}
+	// Only known once opened: a memory-mapped file may end in preallocated space
+	segmentBaseBytes = outputFile->GetSizeAtOpen();
+	outputOffset = segmentBaseBytes;
+}
+
+void LoggerBase::CloseOutputFile() {
+	lock_guard<mutex> lock(outputMutex);
+	if (outputFile)
+		outputFile->Close();
+	outputFile.reset();
+}
+
+string LoggerBase::EncryptLine(const string& line) {
+	LogStageTimer timer(stageTimings, LogStage::ENCRYPT);
+	return GetEncryptedLinePrefix() + cryptofy(line);
+}
+
+void LoggerBase::WriteEncryptedLineToFile(string line, const int64_t index_time) {
+	if (asyncWriter) {
+		asyncWriter->Enqueue({ move(line), true, 1, false, index_time });
+		return;
+	}
+	WriteLineToOutput(EncryptLine(line), 1, index_time);
+}
+
+void LoggerBase::AddToRollups(const LogRow& values) {
+	if (encryptData or rollupIntervals.empty() or (rollups.empty() and !OpenRollups()))
+		return;
+
+	for (size_t i = 0; i < rollupColumns.size(); i++) {
+		// Integers beyond float precision stay exact as doubles
+		const LogValue& value = values[rollupColumns[i]];
+		rollupValues[i] = value.type == LogColumnType::INT ? double(value.intValue) : double(values.GetAsFloat(rollupColumns[i]));
+	}
+	time_t now = std::time(nullptr);
+	for (auto& rollup : rollups) {
+		if (!rollup->Add(now, rollupValues))
+			e << "Failed to write rollup file \"" << MakeLogRollupPath(filePath, rollup->GetBucketSeconds()) << "\"." << endl;
+	}
+}
+
+void LoggerBase::AddToRollups(const vector<string>& values) {
+	if (encryptData or rollupIntervals.empty() or (rollups.empty() and !OpenRollups()))
+		return;
+
+	for (size_t i = 0; i < rollupColumns.size(); i++) {
+		const string& text = values[rollupColumns[i]];
+		double value;
+		auto parsed = from_chars(text.data(), text.data() + text.size(), value);
+		rollupValues[i] = parsed.ec == errc() ? value : nan("");
+	}
+	time_t now = std::time(nullptr);
+	for (auto& rollup : rollups) {
+		if (!rollup->Add(now, rollupValues))
+			e << "Failed to write rollup file \"" << MakeLogRollupPath(filePath, rollup->GetBucketSeconds()) << "\"." << endl;
+	}
+}
+
+bool LoggerBase::OpenRollups() {
+	if (!setFilePathSuccessful)
+		return false;
+
+	rollupColumns.clear();
+	vector<string> rolledUpNames;
+	for (size_t col = 2; col < columnNames.size(); col++) {
+		if (columnFormats[col].type == LogColumnType::FLOAT or columnFormats[col].type == LogColumnType::INT) {
+			rollupColumns.push_back(col - 2);
+			rolledUpNames.push_back(columnNames[col]);
+		}
+	}
+	rollupValues.assign(rollupColumns.size(), nan(""));
+
+	for (unsigned int bucketSeconds : rollupIntervals) {
+		auto rollup = make_unique<LogRollup>(bucketSeconds, rolledUpNames);
+		string rollupPath = MakeLogRollupPath(filePath, bucketSeconds);
+		if (!rollup->Open(rollupPath)) {
+			e << "Failed to open rollup file \"" << rollupPath << "\"." << endl;
+			rollups.clear();
+			rollupIntervals.clear();
+			return false;
+		}
+		rollups.push_back(move(rollup));
+	}
+	return !rollups.empty();
+}
+
+void LoggerBase::CloseRollups() {
+	for (auto& rollup : rollups) {
+		if (!rollup->Close())
+			e << "Failed to write rollup file \"" << MakeLogRollupPath(filePath, rollup->GetBucketSeconds()) << "\"." << endl;
+	}
+	rollups.clear();
+}
+
+int64_t LoggerBase::TakeTimeIndexTime(const size_t rows) {
+	if (timeIndexInterval == 0 or writeMode == LogWriteMode::COMPRESSED)
+		return 0;
+	bool due = rowsSinceTimeIndexEntry == 0 or rowsSinceTimeIndexEntry >= timeIndexInterval;
+	if (due)
+		rowsSinceTimeIndexEntry = 0;
+	rowsSinceTimeIndexEntry += rows;
+	return due ? int64_t(std::time(nullptr)) : 0;
+}
+
+void LoggerBase::AddTimeIndexEntry(const int64_t index_time) {
+	// Caller holds outputMutex
+	if (index_time == 0)
+		return;
+	if (!timeIndexWriter.IsOpen() and !timeIndexWriter.Open(MakeLogTimeIndexPath(filePath), outputOffset)) {
+		e << "Failed to open time index for log file \"" << filePath << "\"." << endl;
+		return;
+	}
+	if (!timeIndexWriter.Add(index_time, outputOffset))
+		e << "Failed to write time index for log file \"" << filePath << "\"." << endl;
+}
+
+void LoggerBase::WaitForAsyncWriter() {
+	if (asyncWriter)
+		asyncWriter->WaitUntilDrained();
+}
+
+void LoggerBase::ResetSegment() {
+	segmentRows = 0;
+	rowsSinceTimeIndexEntry = 0;
+	nextRotationTime = GetNextLogRotationTime(rotationPolicy.boundary, std::time(nullptr));
+
+	LogTimestamp now;
+	LogTimestampCache::Instance().Now(now.date, now.time);
+	lock_guard<mutex> lock(outputMutex);
+	nextSegmentIndex = 1;
+	segmentOpenedAt = now.date + " " + now.time;
+	timeIndexWriter.Close();
+	// OpenOutputFile() replaces this with the size of the opened file
+	outputOffset = GetFileSizeOrZero(filePath);
+	segmentFullReportedAt = 0;
+	segmentFull = false;
+}
+
+void LoggerBase::RotateIfDue(const size_t incoming_rows) {
+	if (rotationPolicy.IsEnabled() and setFilePathSuccessful) {
+		bool due = (rotationPolicy.maxBytes > 0 and segmentFull.exchange(false))
+			or (rotationPolicy.maxRows > 0 and segmentRows >= rotationPolicy.maxRows)
+			or (nextRotationTime != 0 and std::time(nullptr) >= nextRotationTime);
+		if (due)
+			StartNewSegment();
+	}
+	segmentRows += incoming_rows;
+}
+
+void LoggerBase::StartNewSegment() {
+	if (!segmentFinalizer)
+		segmentFinalizer = make_unique<LogSegmentFinalizer>();
+
+	segmentRows = 0;
+	rowsSinceTimeIndexEntry = 0;
+	nextRotationTime = GetNextLogRotationTime(rotationPolicy.boundary, std::time(nullptr));
+
+	// The file switch is queued behind lines already waiting for the I/O thread
+	if (asyncWriter) {
+		asyncWriter->Enqueue({ headerLine, encryptData, 1, true });
+		return;
+	}
+
+	RotateOutputFile();
+	if (headerLine.empty())
+		return;
+	if (encryptData)
+		WriteLineToOutput(EncryptLine(headerLine));
+	else
+		WriteLineToOutput(headerLine);
+}
+
+void LoggerBase::RotateOutputFile() {
+	LogTimestamp now;
+	LogTimestampCache::Instance().Now(now.date, now.time);
+
+	lock_guard<mutex> lock(outputMutex);
+	if (outputFile)
+		outputFile->Close();
+
+	error_code ignored;
+	string segmentPath = MakeLogSegmentPath(filePath, nextSegmentIndex);
+	while (filesystem::exists(segmentPath, ignored) or filesystem::exists(segmentPath + LOG_COMPRESSED_FILE_EXTENSION, ignored))
+		segmentPath = MakeLogSegmentPath(filePath, ++nextSegmentIndex);
+	// Segments written in COMPRESSED mode are already compressed, so they are
+	//   named like the segments compressed by the finalizer
+	bool compressed = writeMode == LogWriteMode::COMPRESSED;
+	string segmentFilePath = compressed ? segmentPath + LOG_COMPRESSED_FILE_EXTENSION : segmentPath;
+
+	error_code renameError;
+	filesystem::rename(filePath, segmentFilePath, renameError);
+	if (renameError)
+		e << "Failed to rotate log file \"" << filePath << "\" to \"" << segmentFilePath << "\"." << endl;
+	else {
+		nextSegmentIndex++;
+		timeIndexWriter.Close();
+		outputOffset = 0;
+		error_code indexRenameError;
+		if (filesystem::exists(MakeLogTimeIndexPath(filePath), ignored))
+			filesystem::rename(MakeLogTimeIndexPath(filePath), MakeLogTimeIndexPath(segmentPath), indexRenameError);
+		if (indexRenameError)
+			e << "Failed to move the time index of log file \"" << filePath << "\" to segment \"" << segmentPath << "\"." << endl;
+
+		LogSegmentJob job;
+		job.segmentPath = segmentFilePath;
+		job.indexPath = MakeLogIndexPath(filePath);
+		job.openedAt = segmentOpenedAt;
+		job.closedAt = now.date + " " + now.time;
+		job.compress = rotationPolicy.compress;
+		job.compressed = compressed;
+		segmentFinalizer->Enqueue(move(job));
+		segmentOpenedAt = now.date + " " + now.time;
+	}
+
+	segmentFullReportedAt = 0;
+	segmentBaseBytes = 0;
+	if (outputFile) {
+		if (outputFile->Open(filePath))
+			segmentBaseBytes = outputFile->GetSizeAtOpen();
+		else
+			e << "Failed to open log file: \"" << filePath << "\"." << endl;
+	}
+}
+
+// Counts the bytes as they end up in the file, after encryption and compression
+void LoggerBase::CheckSegmentSize() {
+	if (rotationPolicy.maxBytes == 0)
+		return;
+	uint64_t bytes = outputFile ? segmentBaseBytes + outputFile->GetBytesWritten() : outputOffset;
+	if (bytes >= segmentFullReportedAt + rotationPolicy.maxBytes) {
+		segmentFullReportedAt = bytes;
+		segmentFull = true;
+	}
+}
+
+void LoggerBase::SaveMemoryLogToFileHelper(const string& file_path, bool encrypt, const LogSaveProgressCallback& on_progress) {
 	saveToFileSuccessful = false;
 	if (!PathIsValid(file_path)) {
 		e << "Invalid file path: \"" << file_path << "\"." << endl;
 		return;
 	}
 
-	ofstream file(file_path);
-	if (file.is_open()) {
-		for (string line : logDataInMemory) {
-			if (encrypt)
-				line = GetEncryptedLinePrefix() + cryptofy(line);
-			line = AppendNewLineIfNecessary(line);
-			file << line;
+	saveToFileSuccessful = SaveSnapshotToFile(logDataInMemory.TakeSnapshot(), file_path, encrypt, on_progress, nullptr);
+}
+
+bool LoggerBase::SaveSnapshotToFile(const LogHistory::Snapshot& snapshot, const string& file_path, bool encrypt,
+	const LogSaveProgressCallback& on_progress, const atomic<bool>* cancel_requested) {
+
+	bool readAllLines = true;
+	bool wroteAllLines = true;
+	bool canceled = false;
+	{
+		// Encryption is by far the slowest part of saving, so only then is it worth spreading over all cores
+		size_t threadCount = encrypt ? max(1u, thread::hardware_concurrency()) : 0;
+		ParallelLogSaver saver([encrypt](const string& line, string& out) {
+			size_t start = out.size();
+			if (encrypt) {
+				out += GetEncryptedLinePrefix();
+				out += cryptofy(line);
+			}
+			else
+				out += line;
+			if (out.size() > start and out.back() != '\n')
+				out += '\n';
+		}, threadCount);
+
+		if (!saver.Open(file_path)) {
+			e << "Failed to save to file \"" << file_path << "\".";
+			return false;
 		}
-		file.close();
-		saveToFileSuccessful = true;
+
+		size_t totalLines = snapshot.GetLineCount();
+		if (on_progress)
+			saver.SetProgressCallback([&](size_t lines_saved) { on_progress(lines_saved, totalLines); });
+
+		readAllLines = snapshot.ForEachLine([&](const string& line) {
+			if (cancel_requested != nullptr and *cancel_requested) {
+				canceled = true;
+				return false;
+			}
+			wroteAllLines = saver.AddLine(line);
+			return wroteAllLines;
+		});
+		// A canceled saver discards its remaining lines when it goes out of scope
+		if (!canceled)
+			wroteAllLines = saver.Finish() and wroteAllLines;
 	}
-	else {
-		e << "Failed to save to file \"" << file_path << "\".";
+
+	if (canceled) {
+		remove(file_path.c_str());
+		return false;
 	}
+	if (!wroteAllLines)
+		e << "Failed to save to file \"" << file_path << "\".";
+	else if (!readAllLines)
+		e << "Failed to read back spilled log lines while saving to \"" << file_path << "\".";
+	return readAllLines and wroteAllLines;
 }
 
 void LoggerBase::SetEncryptOption(const bool encrypt_data) {
 	encryptData = encrypt_data;
+	// Spilled history is written as plain text to a temporary file
+	logDataInMemory.SetSpillEnabled(!encrypt_data);
+	// Rollups and columnar output hold the logged values unencrypted
+	if (encrypt_data) {
+		CloseRollups();
+		lock_guard<mutex> lock(outputMutex);
+		columnarWriter.Close();
+	}
 }
 
 void LoggerBase::Reset() {
+	WaitForAsyncWriter();
+	CloseRollups();
+	CloseOutputFile();
+	{
+		lock_guard<mutex> lock(outputMutex);
+		columnarWriter.Close();
+		timeIndexWriter.Close();
+		outputOffset = 0;
+	}
 	filePath = "";
-	logDataInMemory.clear();
+	headerLine = "";
+	segmentFull = false;
+	segmentBaseBytes = 0;
+	segmentFullReportedAt = 0;
+	segmentRows = 0;
+	nextRotationTime = 0;
+	nextSegmentIndex = 1;
+	segmentOpenedAt = "";
+	rowsSinceTimeIndexEntry = 0;
+	logDataInMemory.Clear();
+	typedMemoryLog.Clear();
+	ResetJournal();
 	columnNames.clear();
+	columnFormats.clear();
+	columnCategories.clear();
+	columnUnits.clear();
 	setFilePathSuccessful = false;
 	saveToFileSuccessful = false;
 }
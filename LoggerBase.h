@@ -3,8 +3,8 @@
 *
 * - Call AddColumn("COLUMN_NAME") to designate a comma-separated data attribute for each row.
 * - The first two rows (date and time) are already automatically added for you.
-* - After creating the logger and adding columns, pass in a vector of strings to LogDataPoint()
-*		to commit a line of values to the log.
+* - After creating the logger and adding columns, pass in a vector of strings or a typed
+*		LogRow to LogDataPoint() to commit a line of values to the log.
 * - Can create many individual logger objects, each with its own columns.
 *
 * - Two methods of outputting data to log files:
@@ -42,11 +42,31 @@
 */
 #pragma once
 
+#include <atomic>
+#include <ctime>
 #include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "AsyncLogWriter.h"
+#include "ColumnarLogFile.h"
+#include "LogOutputFile.h"
+#include "LogHistory.h"
+#include "LogJournal.h"
 #include "LogNotifier.h"
+#include "LogRollup.h"
+#include "LogRotation.h"
+#include "LogRow.h"
+#include "LogSchema.h"
+#include "LogStageTimings.h"
+#include "LogTimeIndex.h"
+#include "LogTimestampCache.h"
+#include "TypedLogObserver.h"
 
 
 #define LOG_API __declspec(dllexport)
@@ -63,12 +83,38 @@ LOG_API std::string GetEncryptedLinePrefix();
 LOG_API std::string GetMetadataLinePrefix();
 
 
+// Called while saving the memory log with the lines written so far and the
+// total number of lines being saved.
+using LogSaveProgressCallback = std::function<void(size_t lines_saved, size_t total_lines)>;
+
+
+// State of a save started with LoggerBase::StartSavingMemoryLogToFile(..).
+struct LogSaveStatus {
+	bool running = false;
+	bool succeeded = false;
+	bool canceled = false;
+	size_t linesSaved = 0;
+	size_t totalLines = 0;
+};
+
+
+// How a logger hands its lines to the target log file.
+enum class LogWriteMode {
+	OPEN_PER_LINE,	// Open, append and close the file for every line
+	BUFFERED,		// Keep the file open for the session and buffer lines in memory
+	MEMORY_MAPPED,	// Append lines through a memory-mapped window of a preallocated file
+	COMPRESSED		// Like BUFFERED, but every flush is written as a compressed block
+};
+
+
 class LoggerBase : public LogNotifier {
 
 public:
 	// Create a logger to log to the target file path.
 	//LOG_API LoggerBase(const std::string& file_path);
 	LOG_API LoggerBase();
+	// Flushes any buffered output to the log file and cancels a running background save.
+	LOG_API ~LoggerBase();
 
 
 	//-------------------------------------------------------------------------
@@ -84,16 +130,194 @@ public:
 	LOG_API bool SetFilePathSuccessful() const;
 
 
+	//-------------------------------------------------------------------------
+	// Log output write mode
+
+	// Choose how lines reach the log file. Default: OPEN_PER_LINE.
+	//   - OPEN_PER_LINE reopens the file for every committed line.
+	//   - BUFFERED keeps the file open until the path changes, Reset() is called
+	//     or the logger is destroyed, and writes lines in large chunks
+	//     according to the flush policy.
+	//   - MEMORY_MAPPED also keeps the file open, but copies lines straight into
+	//     a mapped window of a preallocated file (see MappedLogFile.h). The
+	//     file is truncated to its real length when it is closed.
+	//   - COMPRESSED buffers like BUFFERED, but writes every flush as an
+	//     independently compressed block (see CompressedLogFile.h). The file
+	//     must be read with CompressedLogReader.
+	LOG_API void SetWriteMode(const LogWriteMode mode);
+	LOG_API LogWriteMode GetWriteMode() const;
+
+	// In BUFFERED mode, pending lines are written once max_buffered_bytes have
+	//   accumulated or the oldest pending line is older than max_buffer_age_in_ms.
+	//   The policy is checked every time a line is committed, and by FlushIfDue().
+	LOG_API void SetFlushPolicy(const size_t max_buffered_bytes, const unsigned int max_buffer_age_in_ms);
+
+	// Write all pending lines to the log file now.
+	LOG_API void Flush();
+	// Apply the age limit of the flush policy and the group commit interval
+	//   while no lines are being committed. With asynchronous output the I/O
+	//   thread calls this whenever it is idle; otherwise call it regularly,
+	//   e.g. from the logging thread's tick. The limits only hold to within
+	//   how often it is called.
+	LOG_API void FlushIfDue();
+
+	// Choose when BUFFERED, MEMORY_MAPPED or COMPRESSED output is forced to stable storage:
+	//   - OS_BUFFERED (default): only the flush policy applies, no sync.
+	//   - SYNC_EVERY_LINE: every committed line is flushed and synced.
+	//   - GROUP_COMMIT: lines are synced in groups of group_commit_lines, or
+	//     after group_commit_interval_in_ms, whichever comes first. After the
+	//     last line, the interval is only enforced by FlushIfDue().
+	//   Has no effect in OPEN_PER_LINE mode.
+	LOG_API void SetDurabilityPolicy(const LogDurabilityMode mode,
+		const unsigned int group_commit_lines = DEFAULT_GROUP_COMMIT_LINES,
+		const unsigned int group_commit_interval_in_ms = DEFAULT_GROUP_COMMIT_INTERVAL_IN_MS);
+	LOG_API LogDurabilityMode GetDurabilityMode() const;
+
+	// Flush and sync time per commit, for choosing a durability policy.
+	LOG_API LogCommitLatencyStats GetCommitLatencyStats() const;
+
+
+	//-------------------------------------------------------------------------
+	// Asynchronous output
+
+	// Hand committed lines to a background I/O thread instead of writing them
+	//   on the calling thread. Encryption of encrypted lines also moves to the
+	//   I/O thread.
+	//   - queue_capacity bounds the number of lines waiting to be written.
+	//   - policy decides what happens when the queue is full. GROW keeps the
+	//     extra lines in memory without limit, it does not spill them to disk.
+	//   Disabling waits until all queued lines have been written.
+	//   Change this setting while no other thread is logging.
+	LOG_API void SetAsyncWriting(const bool enable,
+		const size_t queue_capacity = DEFAULT_LOG_QUEUE_CAPACITY,
+		const LogQueueFullPolicy policy = LogQueueFullPolicy::BLOCK);
+	LOG_API bool IsAsyncWriting() const;
+
+	// Lines currently waiting for the I/O thread.
+	LOG_API size_t GetWriteQueueDepth() const;
+	// Highest queue depth seen since async writing was enabled.
+	LOG_API size_t GetPeakWriteQueueDepth() const;
+	// Lines discarded by the DROP_OLDEST policy.
+	LOG_API unsigned long long GetDroppedLineCount() const;
+
+
+	//-------------------------------------------------------------------------
+	// Log rotation
+
+	// Split the log file into segments (see LogRotation.h). When a limit is
+	//   reached, the next data point starts a new segment: the current file is
+	//   renamed to the next segment name, a new file is started at the log
+	//   file path and the header line is written to it again. Closed segments
+	//   are checksummed, indexed and optionally compressed on a background
+	//   thread. Limits are checked once per LogDataPoint(s) call. The size
+	//   limit counts bytes as they are written to the file, so with
+	//   asynchronous writing a segment can grow past it by the lines still
+	//   queued. In COMPRESSED mode, segments are already compressed and are
+	//   named "<segment>.lz"; their index rows describe the decompressed text.
+	//   With asynchronous writing and the DROP_OLDEST policy, a rotation can
+	//   be dropped along with lines.
+	LOG_API void SetRotationPolicy(const LogRotationPolicy& policy);
+	LOG_API LogRotationPolicy GetRotationPolicy() const;
+
+	// Start a new segment now, regardless of the rotation policy.
+	LOG_API void RotateLogFile();
+
+	// Blocks until every closed segment has been finalized.
+	LOG_API void WaitForSegmentFinalization();
+	LOG_API size_t GetFinalizedSegmentCount() const;
+
+
+	//-------------------------------------------------------------------------
+	// Time index
+
+	// Keep a sparse index next to the log file (see LogTimeIndex.h) that maps
+	//   the time data points were logged to where their lines are, so readers
+	//   can jump to a time range (LogFileReader::ForEachLineInTimeRange(..))
+	//   instead of scanning the whole file.
+	//   - An entry is added for the first data point of every file and then
+	//     every interval_rows data points. 0 turns the index off (default).
+	//   - Not available in COMPRESSED mode.
+	LOG_API void SetTimeIndexInterval(const size_t interval_rows = DEFAULT_LOG_TIME_INDEX_INTERVAL);
+	LOG_API size_t GetTimeIndexInterval() const;
+
+
+	//-------------------------------------------------------------------------
+	// Rollups
+
+	// Keep per-bucket statistics of the FLOAT and INT columns in small files
+	//   next to the log file (see LogRollup.h), one file per bucket size in
+	//   bucket_seconds, e.g. { LOG_ROLLUP_MINUTE, LOG_ROLLUP_HOUR }. Reports
+	//   over long periods can read these instead of every logged row.
+	//   - Data points go into the bucket of the time they were logged, so
+	//     LogDataPoints(..) with explicit timestamps is not rolled up.
+	//   - Adding a column or changing the file path finishes the current
+	//     buckets and starts new rollup files.
+	//   - Pass an empty list to stop.
+	//   - Rollup files are plain text, so nothing is rolled up while
+	//     encrypting (see SetEncryptOption(..)).
+	LOG_API void SetRollupIntervals(const std::vector<unsigned int>& bucket_seconds);
+	LOG_API std::vector<unsigned int> GetRollupIntervals() const;
+
+
 	//-------------------------------------------------------------------------
 	// Saving log contents to new file at any time
 
 	// Save all data logged so far (including custom lines) to another file.
-	LOG_API void SaveMemoryLogToFile(const std::string& file_path);
-	LOG_API void SaveMemoryLogToFileEncrypted(const std::string& file_path);
+	//   - Lines are written in chunks. When encrypting, the chunks are encrypted
+	//     on all available cores and still written in their original order.
+	//   - on_progress is called on the calling thread after every chunk.
+	LOG_API void SaveMemoryLogToFile(const std::string& file_path,
+		const LogSaveProgressCallback& on_progress = nullptr);
+	LOG_API void SaveMemoryLogToFileEncrypted(const std::string& file_path,
+		const LogSaveProgressCallback& on_progress = nullptr);
 
 	// Returns true if SaveMemoryLogToFile succeeded
 	LOG_API bool SaveSuccessful() const;
 
+	// Same as above, but saves on a background thread and returns immediately.
+	//   - Saves a snapshot of the lines logged up to this call. Taking it does
+	//     not copy the logged lines, and logging continues undisturbed while
+	//     the snapshot is written.
+	//   - Poll GetSaveStatus() for progress and the result.
+	//   - Returns false if the path is invalid or another save is still running.
+	LOG_API bool StartSavingMemoryLogToFile(const std::string& file_path, const bool encrypt = false);
+	LOG_API LogSaveStatus GetSaveStatus() const;
+	// Stop a running background save. The partially written file is deleted.
+	LOG_API void CancelSave();
+	// Blocks until a running background save has finished.
+	LOG_API void WaitForSave();
+
+	// Cap how much of the logged data is kept in memory for saving.
+	//   Older lines beyond the cap are moved to a temporary file and are still
+	//   included when saving. 0 means no limit.
+	//   Default: 64 MB, no line limit.
+	LOG_API void SetMemoryLogLimit(const size_t max_bytes, const size_t max_lines = 0);
+
+
+	//-------------------------------------------------------------------------
+	// Crash recovery
+
+	// Also write every committed line to a checksummed journal (see
+	//   LogJournal.h), so the logged data survives a crash of the application.
+	//   - If the journal holds lines from an earlier session that crashed,
+	//     they are restored as the oldest lines of the in-memory log and
+	//     included when saving.
+	//     Only the records after the journal's last checkpoint are verified,
+	//     and a torn last record is cut off.
+	//   - While the journal is open, SetFilePath(..) cuts off a partially
+	//     written last line of an existing text log file.
+	//   - Call before SetFilePath(..) and before logging anything.
+	//   - Reset() empties the journal. CloseJournal() and destroying the
+	//     logger mark it as closed cleanly: the file is kept, but nothing is
+	//     restored from it and the next session starts it over.
+	//   - Nothing is journaled while encrypting (see SetEncryptOption(..)),
+	//     because the journal is not encrypted.
+	//   Returns the number of restored lines.
+	LOG_API size_t OpenJournal(const std::string& journal_path,
+		const LogOutputPolicy& policy = GetDefaultLogJournalPolicy());
+	// Stop journaling and mark the journal as closed cleanly (see above).
+	LOG_API void CloseJournal();
+
 
 	//-------------------------------------------------------------------------
 	// Logging structured data
@@ -104,10 +328,17 @@ public:
 	//     since the number of columns dictates the required number of values
 	//     passed to the LogDataPoint(..) method.
 	//   - Date and time columns are added automatically. You do not need to log them.
-	LOG_API void AddColumn(const std::string& columnName);
+	//   - The column type only matters for typed outputs such as the columnar file.
+	//   - precision is the number of digits after the decimal point used when
+	//     FLOAT values passed in a LogRow are written as text.
+	//   - category and unit are only passed on to typed observers in the schema
+	//     (see TypedLogObserver.h).
+	LOG_API void AddColumn(const std::string& columnName, const LogColumnType type = LogColumnType::STRING,
+		const int precision = LOG_PRECISION_SHORTEST, const std::string& category = "", const std::string& unit = "");
 
 	// Write the column headers separated by commas in a single line.
 	//   - Should be done after adding columns but before logging data points.
+	//   - Also publishes the columns to typed observers as a new LogSchema.
 	LOG_API void WriteHeaderLine();
 
 	// Log a comma-separated row of values that correspond to the columns
@@ -116,6 +347,78 @@ public:
 	//   - The values must be in the same order as how the columns were added.
 	//   - A date and a time value are added automatically to the beginning
 	LOG_API void LogDataPoint(const std::vector<std::string>& values);
+	// Same as above, but values keep their native type until an output needs
+	//   them as text. Numbers are formatted with the precision of their column.
+	//   Reuse the same LogRow for every data point to avoid allocations.
+	LOG_API void LogDataPoint(const LogRow& values);
+
+	// Log many data points at once, e.g. when importing data buffered by the
+	//   controller or replaying a recorded session.
+	//   - Every row is validated before anything is logged. If one row has the
+	//     wrong number of values, nothing is logged.
+	//   - timestamps is either empty, in which case every row gets the current
+	//     date and time, or holds one timestamp per row.
+	//   - All lines are written to the log file with a single write, and map
+	//     observers, filtered or not, are notified once for the whole batch
+	//     (see LogBatchObserver.h). Typed observers still get one
+	//     onDataPointLogged(..) per data point.
+	//   - Encrypted lines are encrypted on the calling thread, even when
+	//     asynchronous writing is enabled.
+	LOG_API void LogDataPoints(const std::vector<LogRow>& rows,
+		const std::vector<LogTimestamp>& timestamps = std::vector<LogTimestamp>());
+
+	// Append digits (0 to 6) sub-second digits to the time column of each
+	//   data point, e.g. "14:03:27.512" for 3. Default: 0.
+	LOG_API void SetSubsecondDigits(const unsigned int digits);
+	LOG_API unsigned int GetSubsecondDigits() const;
+
+
+	//-------------------------------------------------------------------------
+	// Columnar binary output
+
+	// Additionally write every data point to a binary, column-chunked file
+	//   (see ColumnarLogFile.h). The file is created when the header line is
+	//   written, using the columns added so far as its schema, and is
+	//   overwritten if it already exists. Custom lines are not included.
+	//   The file is not encrypted, so it is not written while encrypting
+	//   (see SetEncryptOption(..)). Pass an empty path to stop columnar output.
+	LOG_API void SetColumnarOutputFilePath(const std::string& file_path,
+		const size_t rows_per_chunk = DEFAULT_COLUMNAR_ROWS_PER_CHUNK);
+	LOG_API std::string GetColumnarOutputFilePath() const;
+
+	// Additionally keep every data point in memory in the columnar encoding,
+	//   typically a tenth of the size of the text lines kept by
+	//   GetMemoryLog..(..): slowly changing temperatures, currents and powers
+	//   are XOR-compressed and regular timestamps delta-of-delta encoded. Like
+	//   the columnar file it starts when the header line is written (or now,
+	//   if it already was) and does not include custom lines.
+	LOG_API void SetTypedMemoryLog(const bool enable,
+		const size_t rows_per_chunk = DEFAULT_COLUMNAR_ROWS_PER_CHUNK);
+	LOG_API bool GetTypedMemoryLog() const;
+	// Read the named columns (all columns if column_names is empty) of every
+	//   data point kept so far. Returns false if the typed memory log has not
+	//   started or a column does not exist.
+	LOG_API bool ReadTypedMemoryLog(const std::vector<std::string>& column_names,
+		std::vector<ColumnarColumnData>& columns) const;
+	LOG_API size_t GetTypedMemoryLogBytes() const;
+
+
+	//-------------------------------------------------------------------------
+	// Pipeline timing
+
+	// Time every stage of logging a data point (see LogStageTimings.h):
+	//   reading the controller, formatting, observers, encryption, the memory
+	//   log and the file write. Off by default; costs two clock reads per
+	//   stage while on.
+	LOG_API void SetStageTimingEnabled(const bool enable);
+	LOG_API bool GetStageTimingEnabled() const;
+	// Latencies recorded since timing was enabled or last reset.
+	LOG_API LogLatencySummary GetStageLatency(const LogStage stage) const;
+	LOG_API void ResetStageLatencies();
+	// While timing is enabled, also write the latencies of every stage as a
+	//   metadata line every interval_in_s seconds. 0 (default) turns this off.
+	LOG_API void SetStageTimingReportInterval(const unsigned int interval_in_s);
+	LOG_API unsigned int GetStageTimingReportInterval() const;
 
 
 	//-------------------------------------------------------------------------
@@ -137,24 +440,119 @@ public:
 protected:
 	std::string filePath;
 	std::ofstream logFile;
-	std::vector<std::string> logDataInMemory;
+	LogHistory logDataInMemory;
 	std::vector<std::string> columnNames;
+	std::vector<LogColumnFormat> columnFormats;
+	std::vector<std::string> columnCategories;
+	std::vector<std::string> columnUnits;
+	bool schemaChanged = false;			// Columns were added since the schema was last published
+	unsigned int subsecondDigits = 0;
 	bool setFilePathSuccessful = false;
 	bool saveToFileSuccessful = false;
+	mutable std::mutex saveStatusMutex;
+	LogSaveStatus saveStatus;
+	std::atomic<bool> saveCancelRequested{ false };
+	std::thread saveThread;
 	bool encryptData = false;
 
+	LogWriteMode writeMode = LogWriteMode::OPEN_PER_LINE;
+	LogOutputPolicy outputPolicy;
+	std::unique_ptr<LogOutputFile> outputFile;
+	mutable std::mutex outputMutex;
+	std::unique_ptr<AsyncLogWriter> asyncWriter;
+
+	std::unique_ptr<LogJournal> journal;
+	std::mutex journalMutex;
+
+	LogRotationPolicy rotationPolicy;
+	std::unique_ptr<LogSegmentFinalizer> segmentFinalizer;
+	std::string headerLine;
+	// Set where lines are written, each time the segment grows by maxBytes
+	std::atomic<bool> segmentFull{ false };
+	std::uint64_t segmentBaseBytes = 0;			// File size when the output file was opened
+	std::uint64_t segmentFullReportedAt = 0;	// Segment bytes when segmentFull was last set
+	size_t segmentRows = 0;
+	std::time_t nextRotationTime = 0;
+	unsigned int nextSegmentIndex = 1;
+	std::string segmentOpenedAt;
+
+	size_t timeIndexInterval = 0;
+	size_t rowsSinceTimeIndexEntry = 0;
+	LogTimeIndexWriter timeIndexWriter;
+	// Bytes in the current log file, counted where lines are written
+	std::uint64_t outputOffset = 0;
+
+	std::vector<unsigned int> rollupIntervals;
+	std::vector<std::unique_ptr<LogRollup>> rollups;
+	// Columns (without date and time) that are rolled up
+	std::vector<size_t> rollupColumns;
+	std::vector<double> rollupValues;
+
+	std::string columnarFilePath;
+	size_t columnarRowsPerChunk = DEFAULT_COLUMNAR_ROWS_PER_CHUNK;
+	ColumnarLogWriter columnarWriter;
+	bool typedMemoryLogEnabled = false;
+	size_t typedMemoryLogRowsPerChunk = DEFAULT_COLUMNAR_ROWS_PER_CHUNK;
+	ColumnarLogHistory typedMemoryLog;
+
+	LogStageTimings stageTimings;
+	unsigned int stageTimingReportInterval = 0;
+	std::time_t nextStageTimingReport = 0;
+
+	// Reused by LogDataPoint(const LogRow&) so formatting does not allocate
+	std::string formattedLine;
+	std::string formattedBatch;
+	LogRow columnarRow;
+	std::shared_ptr<LogDataPointPool> dataPointPool = LogDataPointPool::Create();
+
 	std::vector<std::shared_ptr<LogObserver>> logObservers;
 
 	// If encrypt_data is set to true, each line logged via
-	// WriteHeaderLine() or LogDataPoint(..) will be encrypted.
+	// WriteHeaderLine() or LogDataPoint(..) will be encrypted. While encrypting,
+	// the memory log keeps every line in memory instead of spilling to disk,
+	// no lines are journaled, and there are no rollups or columnar output.
 	LOG_API void SetEncryptOption(const bool encrypt_data);
 
 
 private:
 	std::string AppendNewLineIfNecessary(std::string line);
-	void WriteLineToFile(std::string line);
-	void WriteEncryptedLineToFile(std::string line);
-	void SaveMemoryLogToFileHelper(const std::string& file_path, bool encrypt);
+	void AppendToHistory(const std::string& line);
+	void ResetJournal();
+	void ReportStageTimingsIfDue();
+	void CommitDataPointLine(const std::string& line);
+	void WriteLineToFile(std::string line, const size_t line_count = 1, const std::int64_t index_time = 0);
+	void WriteLineToOutput(std::string line, const size_t line_count = 1, const std::int64_t index_time = 0);
+	std::int64_t TakeTimeIndexTime(const size_t rows);
+	void AddTimeIndexEntry(const std::int64_t index_time);
+	void AddToRollups(const LogRow& values);
+	void AddToRollups(const std::vector<std::string>& values);
+	bool OpenRollups();
+	void CloseRollups();
+	void FormatDataPoint(const std::string& date, const std::string& time, const LogRow& values, std::string& line) const;
+	std::map<std::string, std::string> MakeObserverData(const std::string& date, const std::string& time, const LogRow& values) const;
+	std::map<std::string, std::string> MakeObserverData(const std::string& date, const std::string& time, const LogRow& values,
+		const LogSchema& columns) const;
+	void PublishSchema();
+	void PublishSchemaIfChanged();
+	void NotifyTypedObservers(const std::string& date, const std::string& time, const LogRow& values);
+	void NotifyTypedObservers(const std::string& date, const std::string& time, const std::vector<std::string>& values);
+	void AppendColumnarRow(const std::string& date, const std::string& time, const LogRow& values);
+	void WaitForAsyncWriter();
+	void ResetSegment();
+	void RotateIfDue(const size_t incoming_rows);
+	void StartNewSegment();
+	void RotateOutputFile();
+	void CheckSegmentSize();
+	std::vector<ColumnarColumnInfo> MakeColumnarSchema() const;
+	void OpenColumnarOutput();
+	void OpenOutputFile();
+	void CloseOutputFile();
+	std::string EncryptLine(const std::string& line);
+	void WriteEncryptedLineToFile(std::string line, const std::int64_t index_time = 0);
+	void SaveMemoryLogToFileHelper(const std::string& file_path, bool encrypt,
+		const LogSaveProgressCallback& on_progress);
+	static bool SaveSnapshotToFile(const LogHistory::Snapshot& snapshot, const std::string& file_path, bool encrypt,
+		const LogSaveProgressCallback& on_progress, const std::atomic<bool>* cancel_requested);
 
 };
 
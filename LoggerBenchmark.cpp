@@ -0,0 +1,416 @@
+/**
+* Logger Benchmark : Measures the cost of the logging hot path.
+*
+* - LogDataPoint(..) for several column counts, with encryption on and off
+*		and with 0, 1 and 6 observers: rows/s, bytes/s written and latency
+*		percentiles per data point.
+* - WriteHeaderLine(), CommitLineEncrypt(..) and SaveMemoryLogToFile(..),
+*		the last one saved several times for its latency percentiles.
+* - Readings are synthetic random walks named like the columns of the
+*		CustomLogger categories (power monitors, diode and TEC currents,
+*		temperatures, pulse info), so no laser controller is needed. Observers
+*		pick out the same column groups as RealTimeObserver, either from the
+*		map of text values (parsing them with std::stof) or, as typed
+*		observers, by column ids looked up once in the schema.
+* - CustomLogger itself (its categories' AppendValues(..)) is not measured:
+*		it needs a MainLaserControllerInterface, which is not part of this
+*		library.
+* - Pass --csv to append the results to a file, one line per measurement,
+*		to compare builds or output backends.
+*
+* Usage:
+*
+*	LoggerBenchmark [--rows N] [--dir PATH] [--mode open|buffered|mapped|compressed]
+*		[--async] [--csv FILE]
+*
+*
+* @file LoggerBenchmark.cpp
+* @created October 2026
+* @version 1.0
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "LoggerBase.h"
+
+using namespace std;
+
+
+const vector<size_t> BENCHMARK_COLUMN_COUNTS = { 8, 32, 128 };
+const vector<size_t> BENCHMARK_OBSERVER_COUNTS = { 0, 1, 6 };
+const vector<size_t> BENCHMARK_LINE_LENGTHS = { 64, 512 };
+const size_t BENCHMARK_HEADER_REPEATS = 200;
+const size_t BENCHMARK_SAVE_REPEATS = 20;
+
+// Column name prefixes used by the CustomLogger categories
+const vector<string> BENCHMARK_COLUMN_PREFIXES = {
+	"PowerMonitor-", "SetCurrent-", "ActualCurrent-", "ActualTemp-",
+	"TecCurrent-", "TecVoltage-", "Humidity-", "MotorIndex-"
+};
+
+
+struct BenchmarkOptions {
+	size_t rows = 20000;
+	string directory = filesystem::temp_directory_path().string();
+	LogWriteMode mode = LogWriteMode::BUFFERED;
+	bool async = false;
+	string csvPath;
+};
+
+struct LatencySummary {
+	double p50 = 0.0;
+	double p90 = 0.0;
+	double p99 = 0.0;
+	double p999 = 0.0;
+	double max = 0.0;
+};
+
+
+// Exposes the encryption switch, which LoggerBase leaves to derived loggers.
+class BenchmarkLogger : public LoggerBase {
+public:
+	using LoggerBase::SetEncryptOption;
+};
+
+// Picks out a few column groups and parses their values, like RealTimeObserver.
+class BenchmarkObserver : public LogObserver {
+public:
+	void onDataPointLogged(map<string, string> data) override {
+		for (const auto& entry : data) {
+			if (entry.first.find("TecCurrent-") != string::npos
+				or entry.first.find("ActualTemp-") != string::npos
+				or entry.first.find("PowerMonitor-") != string::npos)
+				sink += stof(entry.second);
+		}
+	}
+
+	float sink = 0.0f;
+};
+
+// Same as above, but finds the columns once in the schema and reads the values by id.
+class TypedBenchmarkObserver : public TypedLogObserver {
+public:
+	void onSchemaPublished(const shared_ptr<const LogSchema>& schema) override {
+		columnIds.clear();
+		for (size_t id = 0; id < schema->Size(); id++) {
+			const string& name = (*schema)[id].name;
+			if (name.find("TecCurrent-") != string::npos
+				or name.find("ActualTemp-") != string::npos
+				or name.find("PowerMonitor-") != string::npos)
+				columnIds.push_back(id);
+		}
+	}
+
+	void onDataPointLogged(const LogDataPointRef& event) override {
+		for (size_t id : columnIds)
+			sink += event->values[id].floatValue;
+	}
+
+	vector<size_t> columnIds;
+	float sink = 0.0f;
+};
+
+// Slowly drifting readings, one per column.
+class SyntheticReadings {
+public:
+	SyntheticReadings(size_t column_count) : values(column_count), random(column_count) {
+		for (size_t col = 0; col < values.size(); col++)
+			values[col] = 10.0f + float(col % 50);
+	}
+
+	void AddColumnsTo(LoggerBase& logger) const {
+		for (size_t col = 0; col < values.size(); col++) {
+			const string& prefix = BENCHMARK_COLUMN_PREFIXES[col % BENCHMARK_COLUMN_PREFIXES.size()];
+			logger.AddColumn(prefix + to_string(col / BENCHMARK_COLUMN_PREFIXES.size()), LogColumnType::FLOAT, 2);
+		}
+	}
+
+	void Next(LogRow& row) {
+		uniform_real_distribution<float> step(-0.05f, 0.05f);
+		row.Clear();
+		for (float& value : values) {
+			value += step(random);
+			row.AddFloat(value);
+		}
+	}
+
+private:
+	vector<float> values;
+	mt19937 random;
+};
+
+
+static LatencySummary Summarize(vector<double>& latencies_in_us) {
+	LatencySummary summary;
+	if (latencies_in_us.empty())
+		return summary;
+
+	sort(latencies_in_us.begin(), latencies_in_us.end());
+	auto percentile = [&latencies_in_us](double fraction) {
+		size_t index = size_t(fraction * double(latencies_in_us.size() - 1));
+		return latencies_in_us[index];
+	};
+	summary.p50 = percentile(0.50);
+	summary.p90 = percentile(0.90);
+	summary.p99 = percentile(0.99);
+	summary.p999 = percentile(0.999);
+	summary.max = latencies_in_us.back();
+	return summary;
+}
+
+static double MicrosecondsSince(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+static uint64_t FileSize(const string& file_path) {
+	error_code ignored;
+	uintmax_t size = filesystem::file_size(file_path, ignored);
+	return size == uintmax_t(-1) ? 0 : uint64_t(size);
+}
+
+// Removes the file if it exists, so every run starts from an empty file
+static string MakeBenchmarkPath(const BenchmarkOptions& options, const string& name) {
+	string path = (filesystem::path(options.directory) / ("LoggerBenchmark_" + name + ".log")).string();
+	error_code ignored;
+	filesystem::remove(path, ignored);
+	return path;
+}
+
+static void ConfigureLogger(BenchmarkLogger& logger, const BenchmarkOptions& options, const string& file_path) {
+	logger.SetWriteMode(options.mode);
+	logger.SetFilePath(file_path);
+	if (options.async)
+		logger.SetAsyncWriting(true);
+}
+
+static void Report(const BenchmarkOptions& options, const string& name, size_t operations, double elapsed_in_us,
+	uint64_t bytes, LatencySummary latency) {
+	double seconds = elapsed_in_us / 1e6;
+	double operationsPerSecond = seconds > 0.0 ? double(operations) / seconds : 0.0;
+	double megabytesPerSecond = seconds > 0.0 ? double(bytes) / seconds / 1e6 : 0.0;
+
+	printf("%-36s %12.0f ops/s %9.2f MB/s   p50 %8.2f  p90 %8.2f  p99 %8.2f  p99.9 %9.2f  max %10.2f us\n",
+		name.c_str(), operationsPerSecond, megabytesPerSecond,
+		latency.p50, latency.p90, latency.p99, latency.p999, latency.max);
+
+	if (options.csvPath.empty())
+		return;
+	bool newFile = FileSize(options.csvPath) == 0;
+	FILE* csv = fopen(options.csvPath.c_str(), "a");
+	if (csv == nullptr)
+		return;
+	if (newFile)
+		fprintf(csv, "benchmark,ops_per_s,mb_per_s,p50_us,p90_us,p99_us,p999_us,max_us\n");
+	fprintf(csv, "%s,%.0f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", name.c_str(), operationsPerSecond, megabytesPerSecond,
+		latency.p50, latency.p90, latency.p99, latency.p999, latency.max);
+	fclose(csv);
+}
+
+
+//-------------------------------------------------------------------------
+// Benchmarks
+
+static void BenchmarkLogDataPoint(const BenchmarkOptions& options, size_t column_count, bool encrypt,
+	size_t observer_count, bool typed_observers) {
+	string name = "LogDataPoint/" + to_string(column_count) + "cols/" + (encrypt ? "enc" : "plain")
+		+ "/" + to_string(observer_count) + (typed_observers ? "typedobs" : "obs");
+	string filePath = MakeBenchmarkPath(options, "datapoint");
+
+	vector<double> latencies;
+	latencies.reserve(options.rows);
+	double elapsed = 0.0;
+	{
+		BenchmarkLogger logger;
+		ConfigureLogger(logger, options, filePath);
+		logger.SetEncryptOption(encrypt);
+
+		SyntheticReadings readings(column_count);
+		readings.AddColumnsTo(logger);
+		for (size_t i = 0; i < observer_count; i++) {
+			if (typed_observers)
+				logger.addTypedObserver(make_shared<TypedBenchmarkObserver>());
+			else
+				logger.addObserver(make_shared<BenchmarkObserver>());
+		}
+		logger.WriteHeaderLine();
+
+		LogRow row;
+		auto start = chrono::steady_clock::now();
+		for (size_t i = 0; i < options.rows; i++) {
+			readings.Next(row);
+			auto before = chrono::steady_clock::now();
+			logger.LogDataPoint(row);
+			latencies.push_back(MicrosecondsSince(before));
+		}
+		logger.Flush();
+		elapsed = MicrosecondsSince(start);
+	}
+
+	Report(options, name, options.rows, elapsed, FileSize(filePath), Summarize(latencies));
+}
+
+static void BenchmarkWriteHeaderLine(const BenchmarkOptions& options, size_t column_count) {
+	string filePath = MakeBenchmarkPath(options, "header");
+
+	vector<double> latencies;
+	double elapsed = 0.0;
+	for (size_t i = 0; i < BENCHMARK_HEADER_REPEATS; i++) {
+		BenchmarkLogger logger;
+		ConfigureLogger(logger, options, filePath);
+		SyntheticReadings(column_count).AddColumnsTo(logger);
+
+		auto before = chrono::steady_clock::now();
+		logger.WriteHeaderLine();
+		logger.Flush();
+		latencies.push_back(MicrosecondsSince(before));
+		elapsed += latencies.back();
+	}
+
+	Report(options, "WriteHeaderLine/" + to_string(column_count) + "cols", BENCHMARK_HEADER_REPEATS, elapsed,
+		FileSize(filePath), Summarize(latencies));
+}
+
+static void BenchmarkCommitLineEncrypt(const BenchmarkOptions& options, size_t line_length) {
+	string filePath = MakeBenchmarkPath(options, "encrypt");
+	string line(line_length, 'x');
+
+	vector<double> latencies;
+	latencies.reserve(options.rows);
+	double elapsed = 0.0;
+	{
+		BenchmarkLogger logger;
+		ConfigureLogger(logger, options, filePath);
+
+		auto start = chrono::steady_clock::now();
+		for (size_t i = 0; i < options.rows; i++) {
+			line[i % line_length] = char('a' + i % 26);
+			auto before = chrono::steady_clock::now();
+			logger.CommitLineEncrypt(line);
+			latencies.push_back(MicrosecondsSince(before));
+		}
+		logger.Flush();
+		elapsed = MicrosecondsSince(start);
+	}
+
+	Report(options, "CommitLineEncrypt/" + to_string(line_length) + "B", options.rows, elapsed,
+		FileSize(filePath), Summarize(latencies));
+}
+
+static void BenchmarkSaveMemoryLog(const BenchmarkOptions& options, size_t column_count, bool encrypt) {
+	string filePath = MakeBenchmarkPath(options, "session");
+	string savePath = MakeBenchmarkPath(options, "saved");
+
+	BenchmarkLogger logger;
+	ConfigureLogger(logger, options, filePath);
+	SyntheticReadings readings(column_count);
+	readings.AddColumnsTo(logger);
+	logger.WriteHeaderLine();
+
+	LogRow row;
+	for (size_t i = 0; i < options.rows; i++) {
+		readings.Next(row);
+		logger.LogDataPoint(row);
+	}
+	logger.Flush();
+
+	vector<double> latencies;
+	double elapsed = 0.0;
+	for (size_t i = 0; i < BENCHMARK_SAVE_REPEATS; i++) {
+		// Every save starts from no file, as the first one does
+		MakeBenchmarkPath(options, "saved");
+		auto before = chrono::steady_clock::now();
+		if (encrypt)
+			logger.SaveMemoryLogToFileEncrypted(savePath);
+		else
+			logger.SaveMemoryLogToFile(savePath);
+		latencies.push_back(MicrosecondsSince(before));
+		elapsed += latencies.back();
+
+		if (!logger.SaveSuccessful()) {
+			printf("SaveMemoryLogToFile failed for \"%s\"\n", savePath.c_str());
+			return;
+		}
+	}
+
+	Report(options, string("SaveMemoryLogToFile/") + to_string(column_count) + "cols/" + (encrypt ? "enc" : "plain"),
+		options.rows * BENCHMARK_SAVE_REPEATS, elapsed, FileSize(savePath) * BENCHMARK_SAVE_REPEATS,
+		Summarize(latencies));
+}
+
+
+//-------------------------------------------------------------------------
+
+static bool ParseOptions(int argc, char* argv[], BenchmarkOptions& options) {
+	for (int i = 1; i < argc; i++) {
+		string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (argument == "--rows" and hasValue)
+			options.rows = size_t(strtoull(argv[++i], nullptr, 10));
+		else if (argument == "--dir" and hasValue)
+			options.directory = argv[++i];
+		else if (argument == "--csv" and hasValue)
+			options.csvPath = argv[++i];
+		else if (argument == "--async")
+			options.async = true;
+		else if (argument == "--mode" and hasValue) {
+			string mode = argv[++i];
+			if (mode == "open")
+				options.mode = LogWriteMode::OPEN_PER_LINE;
+			else if (mode == "buffered")
+				options.mode = LogWriteMode::BUFFERED;
+			else if (mode == "mapped")
+				options.mode = LogWriteMode::MEMORY_MAPPED;
+			else if (mode == "compressed")
+				options.mode = LogWriteMode::COMPRESSED;
+			else
+				return false;
+		}
+		else
+			return false;
+	}
+	return options.rows > 0;
+}
+
+int main(int argc, char* argv[]) {
+	BenchmarkOptions options;
+	if (!ParseOptions(argc, argv, options)) {
+		printf("Usage: LoggerBenchmark [--rows N] [--dir PATH] [--mode open|buffered|mapped|compressed] [--async] [--csv FILE]\n");
+		return 1;
+	}
+
+	printf("%zu rows per run, writing to \"%s\"\n\n", options.rows, options.directory.c_str());
+
+	for (size_t columnCount : BENCHMARK_COLUMN_COUNTS) {
+		for (bool encrypt : { false, true }) {
+			for (size_t observerCount : BENCHMARK_OBSERVER_COUNTS) {
+				BenchmarkLogDataPoint(options, columnCount, encrypt, observerCount, false);
+				if (observerCount > 0)
+					BenchmarkLogDataPoint(options, columnCount, encrypt, observerCount, true);
+			}
+		}
+	}
+	printf("\n");
+
+	for (size_t columnCount : BENCHMARK_COLUMN_COUNTS)
+		BenchmarkWriteHeaderLine(options, columnCount);
+	for (size_t lineLength : BENCHMARK_LINE_LENGTHS)
+		BenchmarkCommitLineEncrypt(options, lineLength);
+	printf("\n");
+
+	for (bool encrypt : { false, true })
+		BenchmarkSaveMemoryLog(options, 32, encrypt);
+
+	// Making a path removes the file left behind by the last run
+	for (const char* name : { "datapoint", "header", "encrypt", "session", "saved" })
+		MakeBenchmarkPath(options, name);
+	return 0;
+}
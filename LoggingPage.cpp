@@ -31,6 +31,7 @@ static wxString TOTAL_LOG_TIME_STR = _("Total Log Time:");
 static wxString TOTAL_DATA_POINTS_STR = _("Total Data Points:");
 static wxString RESET_STR = _("Reset");
 static wxString SAVE_NOW_STR = _("Save Now");
+static wxString CANCEL_SAVE_STR = _("Cancel Save");
 
 
 const vector<LaserStateLogCategoryEnum> LASER_STATE_LOG_CATEGORIES_VISIBLE_TO_USER{
@@ -46,9 +47,9 @@ const vector<LaserStateLogCategoryEnum> LASER_STATE_LOG_CATEGORIES_VISIBLE_TO_US
 
 LoggingPage::LoggingPage(shared_ptr<MainLaserControllerInterface> _lc, wxWindow* parent) :SettingsPage_Base(_lc, parent) {
 	logger = make_shared<CustomLogger>(lc);
-	CustomLogDebugOutput* logDebugOutput = new CustomLogDebugOutput();
-	logger->addObserver(logDebugOutput);
+	logger->addObserver(make_shared<CustomLogDebugOutput>());
 	logTimer.Bind(wxEVT_TIMER, &LoggingPage::OnLogTimer, this, logTimer.GetId());
+	saveTimer.Bind(wxEVT_TIMER, &LoggingPage::OnSaveTimer, this, saveTimer.GetId());
 	wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
 
 	CustomLoggingPanel = new wxPanel(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxTAB_TRAVERSAL);
@@ -334,7 +335,9 @@ void LoggingPage::OnStartButtonClicked(wxCommandEvent& evt) {
 			// Observer to monitor real-time data and handle alarm updates
 			// Observer to monitor real-time data and handle alarm updates
 			RealTimeObserver* observer = new RealTimeObserver(RealTimeTempLogTextCtrl, alarmTextCtrl);
-			logger->addObserver(observer);
+			// Removed from the logger again when the window closes
+			vector<shared_ptr<QueuedLogObserver>> graphObservers;
+			graphObservers.push_back(AddGuiObserver(observer));
 
 
 
@@ -525,7 +528,9 @@ void LoggingPage::OnStartButtonClicked(wxCommandEvent& evt) {
 				updateLayout                      // Layout updater function...
 			);
 
-			logger->addObserver(tecObserver);
+			LogColumnFilter tecColumns;
+			tecColumns.prefixes = { "TecCurrent-", "TecVoltage-", "ActualTemp-" };
+			graphObservers.push_back(AddGuiObserver(tecObserver, tecColumns));
 
 			// Finalize the TEC Panel
 			tecPanel->SetSizer(tecSizer);
@@ -622,7 +627,9 @@ void LoggingPage::OnStartButtonClicked(wxCommandEvent& evt) {
 				diodeTogglePanel,
 				diodeUpdateLayout
 			);
-			logger->addObserver(diodeObserver);
+			LogColumnFilter diodeColumns;
+			diodeColumns.prefixes = { "ActualCurrent-" };
+			graphObservers.push_back(AddGuiObserver(diodeObserver, diodeColumns));
 			
 
 
@@ -721,7 +728,7 @@ void LoggingPage::OnStartButtonClicked(wxCommandEvent& evt) {
 				powerTogglePanel,
 				powerUpdateLayout
 			);
-			logger->addObserver(powerObserver);
+			graphObservers.push_back(AddGuiObserver(powerObserver, logger->GetCategoryFilter(POWER)));
 			powerPanel->SetSizer(powerSizer);
 			scrollSizer->Add(powerPanel, 0, wxEXPAND | wxALL, 5); // Add panel without fixed proportion
 
@@ -818,7 +825,7 @@ void LoggingPage::OnStartButtonClicked(wxCommandEvent& evt) {
 				sensorTogglePanel,
 				sensorUpdateLayout
 			);
-			logger->addObserver(sensorObserver);
+			graphObservers.push_back(AddGuiObserver(sensorObserver, logger->GetCategoryFilter(SENSORS)));
 
 			sensorPanel->SetSizer(sensorSizer);
 			scrollSizer->Add(sensorPanel, 0, wxEXPAND | wxALL, 5);
@@ -851,6 +858,14 @@ void LoggingPage::OnStartButtonClicked(wxCommandEvent& evt) {
 				}, alarmCheckTimer->GetId());
 			alarmCheckTimer->Start(1000);
 
+			// The observers and the alarm timer refer to this window's widgets, so
+			//   they must stop before it is destroyed. Logging carries on without them.
+			graphWindow->Bind(wxEVT_CLOSE_WINDOW, [this, graphObservers, alarmCheckTimer](wxCloseEvent& event) {
+				alarmCheckTimer->Stop();
+				delete alarmCheckTimer;
+				RemoveGuiObservers(graphObservers);
+				event.Skip();
+				});
 
 			graphWindow->Show();
 
@@ -879,6 +894,12 @@ void LoggingPage::OnResetButtonClicked(wxCommandEvent& evt) {
 
 void LoggingPage::OnSaveNowButtonClicked(wxCommandEvent& evt) {
 	STAGE_ACTION("Save log now button clicked")
+		// While a save is running, the button cancels it
+		if (logger->GetSaveStatus().running) {
+			logger->CancelSave();
+			return;
+		}
+
 		wxString defaultLogFileName = "LaserStateLog_(" + lc->GetLaserModel() + ")_(Serial#" + lc->GetSerialNumber() + ")_(" + GenerateDateString() + ")";
 
 	wxFileDialog selectOutputFileDialog(this, (_(SELECT_LOG_OUTPUT_FILE_STR)), "", defaultLogFileName, "LOG files (*.log)|*.log", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
@@ -889,8 +910,12 @@ void LoggingPage::OnSaveNowButtonClicked(wxCommandEvent& evt) {
 	string path = string(selectOutputFileDialog.GetPath());
 	STAGE_ACTION_ARGUMENTS(path)
 		if (PathIsValid(path)) {
-			logger->SaveMemoryLogToFile(path);
-			if (!logger->SaveSuccessful())
+			// Saves on a background thread so the UI stays responsive; OnSaveTimer() reports the result
+			if (logger->StartSavingMemoryLogToFile(path)) {
+				LogStatusMessage->Set(_("Saving log..."));
+				saveTimer.Start(250);
+			}
+			else
 				wxMessageBox("Failed to save log file. You may not have permission to save there.");
 		}
 	RefreshControlsEnabled();
@@ -898,11 +923,50 @@ void LoggingPage::OnSaveNowButtonClicked(wxCommandEvent& evt) {
 }
 
 
+void LoggingPage::OnSaveTimer(wxTimerEvent& event) {
+	LogSaveStatus status = logger->GetSaveStatus();
+	if (status.running) {
+		int percent = status.totalLines > 0 ? int(100 * status.linesSaved / status.totalLines) : 0;
+		LogStatusMessage->Set(wxString::Format(_("Saving log... %d%%"), percent));
+		return;
+	}
+
+	saveTimer.Stop();
+	if (status.succeeded)
+		LogStatusMessage->Set(_("Log saved"));
+	else if (status.canceled)
+		LogStatusMessage->Set(_("Save canceled"));
+	else
+		wxMessageBox("Failed to save log file. You may not have permission to save there.");
+	RefreshControlsEnabled();
+}
+
+
 void LoggingPage::OnLogTimer(wxTimerEvent& event) {
 	totalLogTimeInS++;
 }
 
 
+shared_ptr<QueuedLogObserver> LoggingPage::AddGuiObserver(RealTimeObserver* observer, const LogColumnFilter& filter) {
+	// Observers update widgets, so they run on the GUI thread, not the logging thread.
+	//   One CallAfter(..) drains a whole burst of data points.
+	return logger->addQueuedObserver(shared_ptr<TypedLogObserver>(observer), [this](shared_ptr<QueuedLogObserver> queued) {
+		CallAfter([queued]() { queued->Drain(); });
+	}, LogDispatchCoalescing::NONE, filter);
+}
+
+
+void LoggingPage::RemoveGuiObservers(const vector<shared_ptr<QueuedLogObserver>>& observers) {
+	// Does not wait for the logging thread. Closing the queues on the GUI thread
+	//   makes drains that are already scheduled do nothing, and releases the
+	//   observers while their widgets still exist.
+	for (auto& queued : observers) {
+		logger->removeQueuedObserver(queued);
+		queued->Close();
+	}
+}
+
+
 void LoggingPage::RefreshControlsEnabled() {
 	bool isLogging = logger->IsLogging();
 	bool hasLoggedDataPoints = logger->GetTotalLoggedDataPoints() > 0;
@@ -934,7 +998,9 @@ void LoggingPage::RefreshAll() {
 	bool hasLoggedDataPoints = logger->GetTotalLoggedDataPoints() > 0;
 	RefreshWidgetEnableBasedOnCondition(TimeIntervalTextCtrl, !logger->IsLogging() and !hasLoggedDataPoints);
 	RefreshWidgetEnableBasedOnCondition(ResetLogButton, hasLoggedDataPoints);
-	RefreshWidgetEnableBasedOnCondition(SaveLogNowButton, hasLoggedDataPoints);
+	bool isSaving = logger->GetSaveStatus().running;
+	SetTextBasedOnCondition(SaveLogNowButton, isSaving, _(CANCEL_SAVE_STR), _(SAVE_NOW_STR));
+	RefreshWidgetEnableBasedOnCondition(SaveLogNowButton, hasLoggedDataPoints or isSaving);
 }
 
 
@@ -55,6 +55,7 @@ private:
 	std::shared_ptr<CustomLogger> logger;
 	std::vector<LogCategoryCheckbox*> categoryCheckboxes;
 	wxTimer logTimer;
+	wxTimer saveTimer;
 	std::function<void()> updateLayout__;
 	
 
@@ -112,12 +113,15 @@ private:
 
 	void RefreshControlsEnabled();
 	void CreateChartPanel();
+	std::shared_ptr<QueuedLogObserver> AddGuiObserver(RealTimeObserver* observer, const LogColumnFilter& filter = LogColumnFilter());
+	void RemoveGuiObservers(const std::vector<std::shared_ptr<QueuedLogObserver>>& observers);
 
 	void OnSelectLogOutputFileButtonClicked(wxCommandEvent& evt);
 
 	void OnResetButtonClicked(wxCommandEvent& evt);
 	void OnSaveNowButtonClicked(wxCommandEvent& evt);
 	void OnLogTimer(wxTimerEvent& evt);
+	void OnSaveTimer(wxTimerEvent& evt);
 
 
 	
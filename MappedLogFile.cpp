@@ -0,0 +1,303 @@
+#include <cstring>
+#include <vector>
+
+#include "MappedLogFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const size_t TRAILING_ZERO_SCAN_BLOCK_SIZE = 64 * 1024;
+
+
+MappedLogFile::MappedLogFile(uint64_t extent_size, uint64_t window_size) {
+	uint64_t granularity = GetMappingGranularity();
+	windowSize = (window_size + granularity - 1) / granularity * granularity;
+	if (windowSize == 0)
+		windowSize = granularity;
+	extentSize = extent_size > windowSize ? extent_size : windowSize;
+}
+
+MappedLogFile::~MappedLogFile() {
+	Close();
+}
+
+bool MappedLogFile::Flush() {
+	// Written text is already in the shared page cache
+	return isOpen;
+}
+
+uint64_t MappedLogFile::GetDataLength() const {
+	return dataLength;
+}
+
+uint64_t MappedLogFile::GetOpenedFileSize() const {
+	return dataLength;
+}
+
+bool MappedLogFile::IsFileOpen() const {
+	return isOpen;
+}
+
+bool MappedLogFile::AppendPending(const string& text) {
+	size_t copied = 0;
+	while (copied < text.size()) {
+		if (window == nullptr or dataLength >= windowStart + windowSize) {
+			UnmapWindow();
+			uint64_t granularity = GetMappingGranularity();
+			if (!MapWindowAt(dataLength / granularity * granularity))
+				return false;
+		}
+
+		uint64_t spaceInWindow = windowStart + windowSize - dataLength;
+		size_t count = text.size() - copied;
+		if (count > spaceInWindow)
+			count = size_t(spaceInWindow);
+
+		memcpy(window + (dataLength - windowStart), text.data() + copied, count);
+		dataLength += count;
+		copied += count;
+	}
+	return true;
+}
+
+size_t MappedLogFile::GetPendingBytes() const {
+	return 0;
+}
+
+bool MappedLogFile::EnsureAllocated(uint64_t length) {
+	if (length <= allocatedLength)
+		return true;
+	uint64_t newLength = (length + extentSize - 1) / extentSize * extentSize;
+	if (!SetFileLength(newLength))
+		return false;
+	allocatedLength = newLength;
+	return true;
+}
+
+
+#ifdef _WIN32
+
+bool MappedLogFile::OpenFile(const string& file_path) {
+	HANDLE handle = CreateFileA(file_path.c_str(), GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return false;
+	fileHandle = handle;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(handle, &fileSize)) {
+		CloseHandle(handle);
+		fileHandle = nullptr;
+		return false;
+	}
+
+	allocatedLength = uint64_t(fileSize.QuadPart);
+	dataLength = FindDataLength(allocatedLength);
+	syncedLength = dataLength;
+	isOpen = true;
+	return true;
+}
+
+void MappedLogFile::CloseFile() {
+	UnmapWindow();
+	SetFileLength(dataLength);
+	CloseHandle(fileHandle);
+	fileHandle = nullptr;
+	isOpen = false;
+	allocatedLength = 0;
+	dataLength = 0;
+}
+
+bool MappedLogFile::SyncToDisk() {
+	if (window != nullptr and dataLength > windowStart) {
+		uint64_t dirtyStart = syncedLength > windowStart ? syncedLength : windowStart;
+		uint64_t granularity = GetMappingGranularity();
+		dirtyStart = dirtyStart / granularity * granularity;
+		if (dirtyStart < windowStart)
+			dirtyStart = windowStart;
+		if (!FlushViewOfFile(window + (dirtyStart - windowStart), SIZE_T(dataLength - dirtyStart)))
+			return false;
+	}
+	if (!FlushFileBuffers(fileHandle))
+		return false;
+	syncedLength = dataLength;
+	return true;
+}
+
+bool MappedLogFile::MapWindowAt(uint64_t offset) {
+	if (!EnsureAllocated(offset + windowSize))
+		return false;
+
+	uint64_t mappingEnd = offset + windowSize;
+	HANDLE mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READWRITE,
+		DWORD(mappingEnd >> 32), DWORD(mappingEnd & 0xFFFFFFFF), nullptr);
+	if (mapping == nullptr)
+		return false;
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_WRITE,
+		DWORD(offset >> 32), DWORD(offset & 0xFFFFFFFF), SIZE_T(windowSize));
+	// The view keeps the mapping object alive
+	CloseHandle(mapping);
+	if (view == nullptr)
+		return false;
+
+	window = static_cast<char*>(view);
+	windowStart = offset;
+	return true;
+}
+
+void MappedLogFile::UnmapWindow() {
+	if (window == nullptr)
+		return;
+	UnmapViewOfFile(window);
+	window = nullptr;
+}
+
+bool MappedLogFile::SetFileLength(uint64_t length) {
+	LARGE_INTEGER position;
+	position.QuadPart = LONGLONG(length);
+	return SetFilePointerEx(fileHandle, position, nullptr, FILE_BEGIN) and SetEndOfFile(fileHandle);
+}
+
+// Log text never contains zero bytes, so the real end of the file is just past
+// the last non-zero byte of the preallocated tail.
+uint64_t MappedLogFile::FindDataLength(uint64_t file_length) {
+	uint64_t scanLimit = extentSize + windowSize;
+	uint64_t scanStart = file_length > scanLimit ? file_length - scanLimit : 0;
+	vector<char> block(TRAILING_ZERO_SCAN_BLOCK_SIZE);
+
+	uint64_t blockEnd = file_length;
+	while (blockEnd > scanStart) {
+		uint64_t blockStart = blockEnd - scanStart > block.size() ? blockEnd - block.size() : scanStart;
+		DWORD bytesToRead = DWORD(blockEnd - blockStart);
+		DWORD bytesRead = 0;
+		LARGE_INTEGER position;
+		position.QuadPart = LONGLONG(blockStart);
+		if (!SetFilePointerEx(fileHandle, position, nullptr, FILE_BEGIN)
+			or !ReadFile(fileHandle, block.data(), bytesToRead, &bytesRead, nullptr)
+			or bytesRead != bytesToRead)
+			return file_length;
+
+		for (DWORD i = bytesRead; i > 0; i--) {
+			if (block[i - 1] != 0)
+				return blockStart + i;
+		}
+		blockEnd = blockStart;
+	}
+	return scanStart;
+}
+
+uint64_t MappedLogFile::GetMappingGranularity() const {
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	return systemInfo.dwAllocationGranularity;
+}
+
+#else
+
+bool MappedLogFile::OpenFile(const string& file_path) {
+	int descriptor = open(file_path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (descriptor < 0)
+		return false;
+	fileDescriptor = descriptor;
+
+	struct stat fileStatus;
+	if (fstat(descriptor, &fileStatus) != 0) {
+		close(descriptor);
+		fileDescriptor = -1;
+		return false;
+	}
+
+	allocatedLength = uint64_t(fileStatus.st_size);
+	dataLength = FindDataLength(allocatedLength);
+	syncedLength = dataLength;
+	isOpen = true;
+	return true;
+}
+
+void MappedLogFile::CloseFile() {
+	UnmapWindow();
+	SetFileLength(dataLength);
+	close(fileDescriptor);
+	fileDescriptor = -1;
+	isOpen = false;
+	allocatedLength = 0;
+	dataLength = 0;
+}
+
+bool MappedLogFile::SyncToDisk() {
+	if (window != nullptr and dataLength > windowStart) {
+		uint64_t dirtyStart = syncedLength > windowStart ? syncedLength : windowStart;
+		uint64_t granularity = GetMappingGranularity();
+		dirtyStart = dirtyStart / granularity * granularity;
+		if (dirtyStart < windowStart)
+			dirtyStart = windowStart;
+		if (msync(window + (dirtyStart - windowStart), size_t(dataLength - dirtyStart), MS_SYNC) != 0)
+			return false;
+	}
+	if (fdatasync(fileDescriptor) != 0)
+		return false;
+	syncedLength = dataLength;
+	return true;
+}
+
+bool MappedLogFile::MapWindowAt(uint64_t offset) {
+	if (!EnsureAllocated(offset + windowSize))
+		return false;
+
+	void* view = mmap(nullptr, size_t(windowSize), PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, off_t(offset));
+	if (view == MAP_FAILED)
+		return false;
+
+	window = static_cast<char*>(view);
+	windowStart = offset;
+	return true;
+}
+
+void MappedLogFile::UnmapWindow() {
+	if (window == nullptr)
+		return;
+	munmap(window, size_t(windowSize));
+	window = nullptr;
+}
+
+bool MappedLogFile::SetFileLength(uint64_t length) {
+	return ftruncate(fileDescriptor, off_t(length)) == 0;
+}
+
+// Log text never contains zero bytes, so the real end of the file is just past
+// the last non-zero byte of the preallocated tail.
+uint64_t MappedLogFile::FindDataLength(uint64_t file_length) {
+	uint64_t scanLimit = extentSize + windowSize;
+	uint64_t scanStart = file_length > scanLimit ? file_length - scanLimit : 0;
+	vector<char> block(TRAILING_ZERO_SCAN_BLOCK_SIZE);
+
+	uint64_t blockEnd = file_length;
+	while (blockEnd > scanStart) {
+		uint64_t blockStart = blockEnd - scanStart > block.size() ? blockEnd - block.size() : scanStart;
+		size_t bytesToRead = size_t(blockEnd - blockStart);
+		if (pread(fileDescriptor, block.data(), bytesToRead, off_t(blockStart)) != ssize_t(bytesToRead))
+			return file_length;
+
+		for (size_t i = bytesToRead; i > 0; i--) {
+			if (block[i - 1] != 0)
+				return blockStart + i;
+		}
+		blockEnd = blockStart;
+	}
+	return scanStart;
+}
+
+uint64_t MappedLogFile::GetMappingGranularity() const {
+	return uint64_t(sysconf(_SC_PAGESIZE));
+}
+
+#endif
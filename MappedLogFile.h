@@ -0,0 +1,82 @@
+/**
+* Mapped Log File : Appends log text through a memory-mapped window that
+*	slides forward through a preallocated file.
+*
+* - The file is grown in large extents ahead of the write position, and a
+*		window of it is mapped into memory. Write(..) is a memcpy into the
+*		window; no system call is made until the window is full.
+* - On Close() the file is truncated to the length actually written.
+* - If the previous session ended without Close() (e.g. a crash), trailing
+*		preallocated zero bytes are trimmed when the file is opened again.
+* - Readers tailing the file see written text immediately (it lives in the
+*		shared page cache), followed by zero bytes up to the preallocated end.
+* - Flush() is a no-op since text is already in the page cache. Commit() writes
+*		the dirty part of the window back and syncs the file.
+*
+*
+* @file MappedLogFile.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "LogOutputFile.h"
+
+
+const std::uint64_t DEFAULT_MAPPED_LOG_EXTENT_SIZE = 16 * 1024 * 1024;
+const std::uint64_t DEFAULT_MAPPED_LOG_WINDOW_SIZE = 4 * 1024 * 1024;
+
+
+class MappedLogFile : public LogOutputFile {
+
+public:
+	// Window size is rounded up to the system's mapping granularity.
+	MappedLogFile(std::uint64_t extent_size = DEFAULT_MAPPED_LOG_EXTENT_SIZE,
+		std::uint64_t window_size = DEFAULT_MAPPED_LOG_WINDOW_SIZE);
+	~MappedLogFile();
+
+	bool Flush() override;
+
+	// Bytes of log text in the file (excluding preallocated space).
+	std::uint64_t GetDataLength() const;
+
+
+protected:
+	bool OpenFile(const std::string& file_path) override;
+	void CloseFile() override;
+	bool IsFileOpen() const override;
+	bool AppendPending(const std::string& text) override;
+	size_t GetPendingBytes() const override;
+	bool SyncToDisk() override;
+	// Without the preallocated space
+	std::uint64_t GetOpenedFileSize() const override;
+
+
+private:
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+#else
+	int fileDescriptor = -1;
+#endif
+	bool isOpen = false;
+
+	std::uint64_t extentSize;
+	std::uint64_t windowSize;
+	std::uint64_t allocatedLength = 0;	// Current file size, including preallocated space
+	std::uint64_t dataLength = 0;		// Bytes of real log text
+
+	char* window = nullptr;
+	std::uint64_t windowStart = 0;		// File offset of the mapped window
+	std::uint64_t syncedLength = 0;		// Data before this offset has been synced
+
+	bool MapWindowAt(std::uint64_t offset);
+	void UnmapWindow();
+	bool EnsureAllocated(std::uint64_t length);
+	bool SetFileLength(std::uint64_t length);
+	std::uint64_t FindDataLength(std::uint64_t file_length);
+	std::uint64_t GetMappingGranularity() const;
+
+};
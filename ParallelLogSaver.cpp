@@ -0,0 +1,140 @@
+#include <algorithm>
+
+#include "ParallelLogSaver.h"
+
+using namespace std;
+
+
+ParallelLogSaver::ParallelLogSaver(function<void(const string&, string&)> format_line,
+	size_t thread_count, size_t lines_per_chunk) :
+	formatLine(format_line), linesPerChunk(max<size_t>(lines_per_chunk, 1)),
+	maxChunksInFlight(max<size_t>(2 * thread_count, 1)) {
+
+	for (size_t i = 0; i < thread_count; i++)
+		workers.emplace_back(&ParallelLogSaver::WorkerLoop, this);
+}
+
+ParallelLogSaver::~ParallelLogSaver() {
+	StopWorkers();
+}
+
+bool ParallelLogSaver::Open(const string& file_path) {
+	file.open(file_path);
+	return file.is_open();
+}
+
+bool ParallelLogSaver::AddLine(const string& line) {
+	if (!currentChunk) {
+		currentChunk = make_shared<Chunk>();
+		currentChunk->lines.reserve(linesPerChunk);
+	}
+	currentChunk->lines.push_back(line);
+	if (currentChunk->lines.size() >= linesPerChunk)
+		SubmitChunk();
+	return !writeFailed;
+}
+
+bool ParallelLogSaver::Finish() {
+	if (currentChunk)
+		SubmitChunk();
+	WriteFormattedChunks(true);
+	StopWorkers();
+
+	if (file.is_open())
+		file.close();
+	return !writeFailed and !file.fail();
+}
+
+void ParallelLogSaver::SetProgressCallback(function<void(size_t)> on_progress) {
+	onProgress = on_progress;
+}
+
+size_t ParallelLogSaver::GetLinesWritten() const {
+	return linesWritten;
+}
+
+void ParallelLogSaver::WorkerLoop() {
+	unique_lock<mutex> lock(chunksMutex);
+	while (true) {
+		chunksChanged.wait(lock, [this]() { return stopRequested or !toFormat.empty(); });
+		if (stopRequested)
+			return;
+
+		shared_ptr<Chunk> chunk = toFormat.front();
+		toFormat.pop_front();
+		lock.unlock();
+
+		FormatChunk(*chunk);
+
+		lock.lock();
+		chunk->formatted = true;
+		chunksChanged.notify_all();
+	}
+}
+
+void ParallelLogSaver::SubmitChunk() {
+	shared_ptr<Chunk> chunk = move(currentChunk);
+	currentChunk.reset();
+
+	if (workers.empty()) {
+		FormatChunk(*chunk);
+		WriteChunk(*chunk);
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(chunksMutex);
+		writeOrder.push_back(chunk);
+		toFormat.push_back(chunk);
+	}
+	chunksChanged.notify_all();
+	WriteFormattedChunks(false);
+}
+
+void ParallelLogSaver::WriteFormattedChunks(bool wait_for_all) {
+	unique_lock<mutex> lock(chunksMutex);
+	while (!writeOrder.empty()) {
+		shared_ptr<Chunk> oldest = writeOrder.front();
+		if (!oldest->formatted) {
+			// Keep the workers busy until too many chunks are waiting to be written
+			if (!wait_for_all and writeOrder.size() < maxChunksInFlight)
+				return;
+			chunksChanged.wait(lock, [&oldest]() { return oldest->formatted; });
+		}
+		writeOrder.pop_front();
+
+		lock.unlock();
+		WriteChunk(*oldest);
+		lock.lock();
+	}
+}
+
+void ParallelLogSaver::FormatChunk(Chunk& chunk) const {
+	for (const string& line : chunk.lines)
+		formatLine(line, chunk.text);
+}
+
+void ParallelLogSaver::WriteChunk(Chunk& chunk) {
+	if (!writeFailed) {
+		file.write(chunk.text.data(), chunk.text.size());
+		writeFailed = file.fail();
+	}
+	linesWritten += chunk.lines.size();
+	chunk = Chunk();
+
+	if (onProgress)
+		onProgress(linesWritten);
+}
+
+void ParallelLogSaver::StopWorkers() {
+	{
+		lock_guard<mutex> lock(chunksMutex);
+		stopRequested = true;
+	}
+	chunksChanged.notify_all();
+	for (thread& worker : workers) {
+		if (worker.joinable())
+			worker.join();
+	}
+	workers.clear();
+}
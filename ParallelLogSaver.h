@@ -0,0 +1,102 @@
+/**
+* Parallel Log Saver : Writes lines to a file in their original order while a
+*	pool of threads formats (e.g. encrypts) them in chunks.
+*
+* - Lines are collected into chunks of lines_per_chunk lines. Each full chunk is
+*		formatted by a worker thread and written by the thread calling AddLine(..)
+*		or Finish(), strictly in the order the chunks were started.
+* - At most 2 chunks per worker are in flight, so memory use stays bounded
+*		no matter how many lines are saved.
+* - With thread_count 0 every chunk is formatted on the calling thread.
+* - The format function must be safe to call from several threads at once.
+*
+* Example usage:
+*
+*	ParallelLogSaver saver(
+*		[](const std::string& line, std::string& out) { out += line + "\n"; },
+*		std::thread::hardware_concurrency());
+*	saver.Open("C:/Users/jbutcher/Documents/saved.log");
+*	for (auto& line : lines)
+*		saver.AddLine(line);
+*	bool success = saver.Finish();
+*
+*
+* @file ParallelLogSaver.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+const size_t DEFAULT_SAVE_LINES_PER_CHUNK = 4096;
+
+
+class ParallelLogSaver {
+
+public:
+	// format_line appends the formatted line (including its line ending) to out.
+	ParallelLogSaver(std::function<void(const std::string& line, std::string& out)> format_line,
+		size_t thread_count, size_t lines_per_chunk = DEFAULT_SAVE_LINES_PER_CHUNK);
+	// Stops the workers. Lines not yet written are discarded unless Finish() was called.
+	~ParallelLogSaver();
+
+	ParallelLogSaver(const ParallelLogSaver&) = delete;
+	ParallelLogSaver& operator=(const ParallelLogSaver&) = delete;
+
+	// Create (or overwrite) the target file.
+	bool Open(const std::string& file_path);
+
+	// Returns false once writing to the file has failed.
+	bool AddLine(const std::string& line);
+
+	// Write all remaining lines and close the file.
+	bool Finish();
+
+	// Called on the saving thread after every chunk written to the file.
+	void SetProgressCallback(std::function<void(size_t lines_written)> on_progress);
+
+	size_t GetLinesWritten() const;
+
+
+private:
+	struct Chunk {
+		std::vector<std::string> lines;
+		std::string text;
+		bool formatted = false;
+	};
+
+	std::function<void(const std::string&, std::string&)> formatLine;
+	std::function<void(size_t)> onProgress;
+	size_t linesPerChunk;
+	size_t maxChunksInFlight;
+
+	std::ofstream file;
+	std::shared_ptr<Chunk> currentChunk;
+	size_t linesWritten = 0;
+	bool writeFailed = false;
+
+	std::mutex chunksMutex;
+	std::condition_variable chunksChanged;
+	std::deque<std::shared_ptr<Chunk>> writeOrder;
+	std::deque<std::shared_ptr<Chunk>> toFormat;
+	bool stopRequested = false;
+	std::vector<std::thread> workers;
+
+	void WorkerLoop();
+	void SubmitChunk();
+	void WriteFormattedChunks(bool wait_for_all);
+	void FormatChunk(Chunk& chunk) const;
+	void WriteChunk(Chunk& chunk);
+	void StopWorkers();
+
+};
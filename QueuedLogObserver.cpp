@@ -0,0 +1,151 @@
+#include "QueuedLogObserver.h"
+
+using namespace std;
+
+
+QueuedLogObserver::QueuedLogObserver(shared_ptr<LogObserver> _target, LogDispatchCoalescing _coalescing, size_t capacity)
+	: target(move(_target)), coalescing(_coalescing), queue(capacity) {
+}
+
+QueuedLogObserver::QueuedLogObserver(shared_ptr<TypedLogObserver> _target, LogDispatchCoalescing _coalescing, size_t capacity)
+	: typedTarget(move(_target)), coalescing(_coalescing), queue(capacity) {
+}
+
+void QueuedLogObserver::SetWakeCallback(function<void()> wake) {
+	wakeCallback = move(wake);
+}
+
+void QueuedLogObserver::SetColumnFilter(const LogColumnFilter& filter) {
+	columnFilter = filter;
+}
+
+void QueuedLogObserver::onDataPointLogged(map<string, string> data) {
+	QueuedDataPoint dataPoint;
+	dataPoint.data = move(data);
+	Enqueue(move(dataPoint));
+	WakeIfIdle();
+}
+
+void QueuedLogObserver::onDataPointsLogged(const vector<map<string, string>>& data) {
+	// One wake for the whole batch
+	for (auto& values : data) {
+		QueuedDataPoint dataPoint;
+		dataPoint.data = values;
+		Enqueue(move(dataPoint));
+	}
+	WakeIfIdle();
+}
+
+void QueuedLogObserver::onSchemaPublished(const shared_ptr<const LogSchema>&) {
+	// Every queued event carries its schema; it is passed on in Deliver(..)
+}
+
+void QueuedLogObserver::onDataPointLogged(const LogDataPointRef& event) {
+	// Only the reference is copied; the values stay in the shared buffer
+	QueuedDataPoint dataPoint;
+	dataPoint.event = event;
+	Enqueue(move(dataPoint));
+	WakeIfIdle();
+}
+
+size_t QueuedLogObserver::Drain() {
+	// Cleared first, so data points queued during the drain wake the owner again
+	drainPending.store(false, memory_order_seq_cst);
+	if (IsClosed()) {
+		// Pushed while Close() ran
+		QueuedDataPoint dropped;
+		while (queue.TryPop(dropped)) {}
+		return 0;
+	}
+
+	// Only what was queued when the drain started, so a fast producer cannot keep it running forever
+	size_t available = queue.ApproximateSize();
+	size_t popped = 0;
+	size_t delivered = 0;
+	QueuedDataPoint dataPoint;
+	while (popped < available and queue.TryPop(dataPoint)) {
+		popped++;
+		if (coalescing == LogDispatchCoalescing::LATEST and popped < available)
+			continue;
+		Deliver(dataPoint);
+		delivered++;
+	}
+
+	if (coalescing == LogDispatchCoalescing::LATEST and popped > 0 and delivered == 0) {
+		// Fewer were left than counted; the last one popped is the newest
+		Deliver(dataPoint);
+		delivered = 1;
+	}
+	if (popped > delivered)
+		coalescedCount.fetch_add(popped - delivered, memory_order_relaxed);
+
+	if (queue.ApproximateSize() > 0)
+		WakeIfIdle();
+	return delivered;
+}
+
+void QueuedLogObserver::Close() {
+	closed.store(true, memory_order_seq_cst);
+	target.reset();
+	typedTarget.reset();
+	deliveredSchema.reset();
+	QueuedDataPoint dropped;
+	while (queue.TryPop(dropped)) {}
+}
+
+bool QueuedLogObserver::IsClosed() const {
+	return closed.load(memory_order_seq_cst);
+}
+
+size_t QueuedLogObserver::GetQueuedCount() const {
+	return queue.ApproximateSize();
+}
+
+uint64_t QueuedLogObserver::GetDroppedCount() const {
+	return droppedCount.load(memory_order_relaxed);
+}
+
+uint64_t QueuedLogObserver::GetCoalescedCount() const {
+	return coalescedCount.load(memory_order_relaxed);
+}
+
+void QueuedLogObserver::Enqueue(QueuedDataPoint&& dataPoint) {
+	if (IsClosed())
+		return;
+	if (queue.TryPush(move(dataPoint)))
+		return;
+
+	if (coalescing == LogDispatchCoalescing::LATEST) {
+		// Only the newest data point matters, so make room by dropping the oldest
+		QueuedDataPoint oldest;
+		while (!queue.TryPush(move(dataPoint))) {
+			if (queue.TryPop(oldest))
+				coalescedCount.fetch_add(1, memory_order_relaxed);
+		}
+		return;
+	}
+	droppedCount.fetch_add(1, memory_order_relaxed);
+}
+
+void QueuedLogObserver::Deliver(QueuedDataPoint& dataPoint) {
+	if (target) {
+		target->onDataPointLogged(move(dataPoint.data));
+		return;
+	}
+	if (!typedTarget or !dataPoint.event)
+		return;
+	if (dataPoint.event->schema != deliveredSchema) {
+		deliveredSchema = dataPoint.event->schema;
+		typedTarget->onSchemaPublished(columnFilter.Project(deliveredSchema));
+	}
+	typedTarget->onDataPointLogged(dataPoint.event);
+	// Back to the pool as soon as every observer is done with it
+	dataPoint.event.Reset();
+}
+
+void QueuedLogObserver::WakeIfIdle() {
+	if (IsClosed())
+		return;
+	if (!drainPending.exchange(true, memory_order_seq_cst) and wakeCallback)
+		wakeCallback();
+}
@@ -0,0 +1,129 @@
+/**
+* Queued Log Observer : Delivers data points to an observer on a thread of
+*	its own choosing instead of on the logging thread.
+*
+* - Wraps an observer, either a LogObserver or a TypedLogObserver (see
+*		TypedLogObserver.h). The logging thread only moves each data point into a
+*		lock-free bounded queue (see BoundedLogQueue.h) and returns, so a slow
+*		observer, e.g. one that repaints plots, never delays acquisition.
+* - The owner calls Drain() on the thread the observer belongs to (the GUI
+*		thread for wxWidgets observers), which delivers the queued data points.
+* - The wake callback runs on the logging thread when data points arrive
+*		while no drain is pending, i.e. once per burst, not once per data
+*		point. It must be cheap and thread-safe, e.g. wxEvtHandler::CallAfter(..)
+*		or posting to an executor.
+* - With LogDispatchCoalescing::LATEST a drain only delivers the newest data
+*		point of a burst, for observers that only show current values.
+* - If the queue is full, the newest data point is dropped (or, with LATEST,
+*		the oldest); the logging thread never waits. GetDroppedCount() tells
+*		how many were lost.
+* - After the queue is removed from the logger, Close() drops what is still
+*		queued and releases the observer, so drains that were already
+*		scheduled deliver nothing.
+* - Typed data points are queued by reference, sharing the logger's buffer
+*		with all other observers. They keep the schema they were logged with,
+*		and a typed observer is sent onSchemaPublished(..) during the drain,
+*		just before the first data point with a new schema, projected by the
+*		column filter if one was set (see LogColumnFilter.h).
+*
+* Example usage (in a wxWindow, see LogNotifier::addQueuedObserver(..)):
+*
+*	logger->addQueuedObserver(observer, [this](std::shared_ptr<QueuedLogObserver> queued) {
+*		CallAfter([queued]() { queued->Drain(); });
+*	});
+*
+*
+* @file QueuedLogObserver.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "BoundedLogQueue.h"
+#include "LogBatchObserver.h"
+#include "LogColumnFilter.h"
+#include "LogObserver.h"
+#include "TypedLogObserver.h"
+
+
+const size_t DEFAULT_OBSERVER_QUEUE_CAPACITY = 1024;
+
+
+enum class LogDispatchCoalescing {
+	NONE,	// Deliver every data point
+	LATEST	// Deliver only the newest data point queued since the last drain
+};
+
+
+class QueuedLogObserver : public LogObserver, public LogBatchObserver, public TypedLogObserver {
+
+public:
+	QueuedLogObserver(std::shared_ptr<LogObserver> _target,
+		LogDispatchCoalescing _coalescing = LogDispatchCoalescing::NONE,
+		size_t capacity = DEFAULT_OBSERVER_QUEUE_CAPACITY);
+	QueuedLogObserver(std::shared_ptr<TypedLogObserver> _target,
+		LogDispatchCoalescing _coalescing = LogDispatchCoalescing::NONE,
+		size_t capacity = DEFAULT_OBSERVER_QUEUE_CAPACITY);
+
+	QueuedLogObserver(const QueuedLogObserver&) = delete;
+	QueuedLogObserver& operator=(const QueuedLogObserver&) = delete;
+
+	// Set before the observer is added to a logger. Must not own this observer.
+	void SetWakeCallback(std::function<void()> wake);
+	// Set before the observer is added to a logger. Only used for a typed observer.
+	void SetColumnFilter(const LogColumnFilter& filter);
+
+	// Called by the logger; queue the data points.
+	void onDataPointLogged(std::map<std::string, std::string> data) override;
+	void onDataPointsLogged(const std::vector<std::map<std::string, std::string>>& data) override;
+	void onSchemaPublished(const std::shared_ptr<const LogSchema>& schema) override;
+	void onDataPointLogged(const LogDataPointRef& event) override;
+
+	// Deliver the queued data points to the observer. Call from one thread at a
+	//   time. Returns the number of data points delivered.
+	size_t Drain();
+
+	// Stop delivering: drop the queued data points and release the observer.
+	//   Call from the thread that calls Drain().
+	void Close();
+	bool IsClosed() const;
+
+	size_t GetQueuedCount() const;
+	std::uint64_t GetDroppedCount() const;
+	// Data points skipped by LogDispatchCoalescing::LATEST.
+	std::uint64_t GetCoalescedCount() const;
+
+
+private:
+	// Only the member that matches the target is used.
+	struct QueuedDataPoint {
+		std::map<std::string, std::string> data;
+		LogDataPointRef event;
+	};
+
+	std::shared_ptr<LogObserver> target;
+	std::shared_ptr<TypedLogObserver> typedTarget;
+	std::shared_ptr<const LogSchema> deliveredSchema;	// Schema of the last data point sent to typedTarget
+	LogColumnFilter columnFilter;
+	LogDispatchCoalescing coalescing;
+	BoundedLogQueue<QueuedDataPoint> queue;
+	std::function<void()> wakeCallback;
+	std::atomic<bool> drainPending{ false };
+	std::atomic<bool> closed{ false };
+	std::atomic<std::uint64_t> droppedCount{ 0 };
+	std::atomic<std::uint64_t> coalescedCount{ 0 };
+
+	void Enqueue(QueuedDataPoint&& dataPoint);
+	void Deliver(QueuedDataPoint& dataPoint);
+	void WakeIfIdle();
+
+};
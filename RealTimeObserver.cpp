@@ -2,121 +2,110 @@
 #include <wx/datetime.h>
 #include <wx/log.h>
 
-void RealTimeObserver::onDataPointLogged(std::map<std::string, std::string> data) {
+void RealTimeObserver::onSchemaPublished(const std::shared_ptr<const LogSchema>& schema) {
+    schema_ = schema;
+    observedColumns_.clear();
+    if (!schema_)
+        return;
+
+    // The schema may only hold the columns this observer subscribed to
+    for (size_t position = 0; position < schema_->Size(); position++) {
+        const std::string& name = (*schema_)[position].name;
+        ObservedColumn column{ (*schema_)[position].id, position, ColumnGroup::None, "" };
+
+        if (name.find("TecCurrent-") != std::string::npos)
+            column.group = ColumnGroup::TecCurrent;
+        else if (name.find("TecVoltage-") != std::string::npos)
+            column.group = ColumnGroup::TecVoltage;
+        else if (name.find("ActualTemp-") != std::string::npos)
+            column.group = ColumnGroup::Temperature;
+        else if (name.find("ActualCurrent-") != std::string::npos)
+            column.group = ColumnGroup::DiodeCurrent;
+        else if (name.find("PowerMonitor-") != std::string::npos)
+            column.group = ColumnGroup::Power;
+        else if (name.find("Flow") != std::string::npos || name.find("Humidity-") != std::string::npos)
+            column.group = ColumnGroup::Sensor;
+        else if (name.find("Alarms") != std::string::npos)
+            column.group = ColumnGroup::Alarm;
+
+        // Plot label: "Flow", or the part after "-"
+        if (column.group == ColumnGroup::Sensor && name.find("Flow") != std::string::npos)
+            column.label = "Flow";
+        else if (column.group != ColumnGroup::None && column.group != ColumnGroup::Alarm)
+            column.label = name.substr(name.find("-") + 1);
+
+        observedColumns_.push_back(column);
+    }
+}
+
+void RealTimeObserver::onDataPointLogged(const LogDataPointRef& event) {
     bool visibilityUpdated = false;
     printf("i received the data");
     textCtrl_->AppendText("Received Data:\n");
     wxString currentTime = wxDateTime::Now().Format("%H:%M:%S");
 
-    
+    if (!schema_)
+        onSchemaPublished(event->schema);
 
-    for (const auto& entry : data) {
-        std::string logEntry = entry.first + ": " + entry.second + "\n";
-        //wxLogMessage("Entry Key: %s, Entry Value: %s", entry.first.c_str(), entry.second.c_str());
+    std::string logEntry;
+    for (const ObservedColumn& column : observedColumns_) {
+        const LogColumnInfo& info = (*schema_)[column.position];
+        logEntry = info.name + ": ";
+        event->values.AppendFormatted(column.id, info.format.precision, logEntry);
+        logEntry += "\n";
         textCtrl_->AppendText(logEntry);
 
-        try {
-            // Handle TEC current values
-            if (entry.first.find("TecCurrent-") != std::string::npos) {
-                float currentValue = std::stof(entry.second);
-                std::string label = entry.first.substr(entry.first.find("-") + 1);
-                currents.push_back(currentValue);
-                currentLabels.push_back(label);
-                currentDataFound = true;
-
-            }
-            // Handle TEC voltage values
-            else if (entry.first.find("TecVoltage-") != std::string::npos) {
-                float voltageValue = std::stof(entry.second);
-                std::string label = entry.first.substr(entry.first.find("-") + 1);
-                voltages.push_back(voltageValue);
-                voltageLabels.push_back(label);
-                voltageDataFound = true;
-            }
-            // Handle TEC temperature values
-            else if (entry.first.find("ActualTemp-") != std::string::npos) {
-                float tempValue = std::stof(entry.second);
-                std::string label = entry.first.substr(entry.first.find("-") + 1);
-                temperatures.push_back(tempValue);
-                tempLabels.push_back(label);
-                tempDataFound = true;
-            }
-            // Handle Diode current values
-            else if (entry.first.find("ActualCurrent-") != std::string::npos) {
-                float diodeCurrentValue = std::stof(entry.second);
-                std::string label = entry.first.substr(entry.first.find("-") + 1);
-                diodeCurrents.push_back(diodeCurrentValue);
-                diodeCurrentLabels.push_back(label);
-                diodeCurrentDataFound = true;
-            }
-            // Handle Power readings
-            else if (entry.first.find("PowerMonitor-") != std::string::npos) {
-            //wxLogMessage("PowerMonitor entry detected: key = %s, value = %s",entry.first.c_str(), entry.second.c_str());
-                float powerValue = std::stof(entry.second);
-                std::string label = entry.first.substr(entry.first.find("-") + 1);
-                powerReadings.push_back(powerValue);
-
-                powerLabels.push_back(label);
-
-                powerDataFound = true;
-                //wxLogMessage("Power value: %.2f, Label: %s", powerValue, label.c_str());
-
-            }
-            // Handle Sensor readings (Flow/Humidity)
-            // Handle Sensor readings (Flow/Humidity)
-            else if (entry.first.find("Flow") != std::string::npos || entry.first.find("Humidity-") != std::string::npos) {
-                float sensorValue = std::stof(entry.second);
-                std::string label;
-
-                // Handle "Flow" and "Humidity-<label>" cases separately
-                if (entry.first.find("Flow") != std::string::npos) {
-                    label = "Flow";  // Directly assign "Flow" as the label
-                }
-                else if (entry.first.find("Humidity-") != std::string::npos) {
-                    label = entry.first.substr(entry.first.find("-") + 1);  // Extract label after "-"
-                }
-
-                sensorReadings.push_back(sensorValue);
-                sensorLabels.push_back(label);
-                sensorDataFound = true;
-
-                //// Log messages for debugging the flow of data
-                ////wxLogMessage("Sensor Value: %.2f", sensorValue);
-                ////wxLogMessage("Current sensorReadings size: %zu", sensorReadings.size());
-                //for (size_t i = 0; i < sensorReadings.size(); ++i) {
-                //    wxLogMessage("sensorReadings[%zu]: %.2f", i, sensorReadings[i]);
-                //}
-                //wxLogMessage("Current sensorLabels size: %zu", sensorLabels.size());
-                //for (size_t i = 0; i < sensorLabels.size(); ++i) {
-                //    wxLogMessage("sensorLabels[%zu]: %s", i, sensorLabels[i].c_str());
-                //}
-                //wxLogMessage("Sensor Data Found: %s", sensorDataFound ? "true" : "false");
-            }
-
-
-
-
-
-            // Handle Alarms
-            else if (entry.first.find("Alarms") != std::string::npos) {
-                if (!entry.second.empty()) {
-                    wxString newAlarmMessage = wxString::FromUTF8(entry.second); 
-                    wxString newAlarmTime = currentTime;  
-                    
-                    if (newAlarmMessage != lastAlarmMessage_ && newAlarmTime != lastAlarmTime_) {
-                        alarms.push_back(entry.second); 
-                        alarmDataFound = true;
-                        alarmMessage_ = newAlarmMessage;  
-                        alarmTime_ = newAlarmTime;  
-                        alarmTriggered_ = true;
-                        lastAlarmMessage_ = newAlarmMessage;
-                        lastAlarmTime_ = newAlarmTime;
-                    }
+        switch (column.group) {
+        case ColumnGroup::TecCurrent:
+            currents.push_back(event->values.GetAsFloat(column.id));
+            currentLabels.push_back(column.label);
+            currentDataFound = true;
+            break;
+        case ColumnGroup::TecVoltage:
+            voltages.push_back(event->values.GetAsFloat(column.id));
+            voltageLabels.push_back(column.label);
+            voltageDataFound = true;
+            break;
+        case ColumnGroup::Temperature:
+            temperatures.push_back(event->values.GetAsFloat(column.id));
+            tempLabels.push_back(column.label);
+            tempDataFound = true;
+            break;
+        case ColumnGroup::DiodeCurrent:
+            diodeCurrents.push_back(event->values.GetAsFloat(column.id));
+            diodeCurrentLabels.push_back(column.label);
+            diodeCurrentDataFound = true;
+            break;
+        case ColumnGroup::Power:
+            powerReadings.push_back(event->values.GetAsFloat(column.id));
+            powerLabels.push_back(column.label);
+            powerDataFound = true;
+            break;
+        case ColumnGroup::Sensor:
+            sensorReadings.push_back(event->values.GetAsFloat(column.id));
+            sensorLabels.push_back(column.label);
+            sensorDataFound = true;
+            break;
+        case ColumnGroup::Alarm: {
+            std::string alarmText(event->values.GetText(column.id));
+            if (!alarmText.empty()) {
+                wxString newAlarmMessage = wxString::FromUTF8(alarmText);
+                wxString newAlarmTime = currentTime;
+
+                if (newAlarmMessage != lastAlarmMessage_ && newAlarmTime != lastAlarmTime_) {
+                    alarms.push_back(alarmText);
+                    alarmDataFound = true;
+                    alarmMessage_ = newAlarmMessage;
+                    alarmTime_ = newAlarmTime;
+                    alarmTriggered_ = true;
+                    lastAlarmMessage_ = newAlarmMessage;
+                    lastAlarmTime_ = newAlarmTime;
                 }
             }
+            break;
         }
-        catch (const std::exception& e) {
-            wxLogError("Error converting data: %s", e.what());
+        default:
+            break;
         }
     }
 
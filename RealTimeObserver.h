@@ -1,15 +1,27 @@
 #pragma once
-#include "../CommonUtilities/Logging/LogObserver.h"
+#include "../CommonUtilities/Logging/TypedLogObserver.h"
 #include "wx/wx.h"
 #include "GraphPlotting.h"
-#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
 // Enum to differentiate between different plot types
 enum class PlotType { Diode, Power, TEC, Sensors };
 
-class RealTimeObserver : public LogObserver {
+class RealTimeObserver : public TypedLogObserver {
 private:
+    // What a column is plotted as, worked out from its name once per schema
+    enum class ColumnGroup { None, TecCurrent, TecVoltage, Temperature, DiodeCurrent, Power, Sensor, Alarm };
+    struct ObservedColumn {
+        size_t id;          // Index of the value in each data point
+        size_t position;    // Index of the column in schema_
+        ColumnGroup group;
+        std::string label;
+    };
+    std::shared_ptr<const LogSchema> schema_;
+    std::vector<ObservedColumn> observedColumns_;
+
     // TEC-related members
     wxPanel* currentPanel_;
     wxPanel* voltagePanel_;
@@ -143,6 +155,7 @@ public:
         return alarmTriggered_;
     }
 
-    // Method to handle new data points
-    void onDataPointLogged(std::map<std::string, std::string> data) override;
+    // Methods to handle a new set of columns and new data points
+    void onSchemaPublished(const std::shared_ptr<const LogSchema>& schema) override;
+    void onDataPointLogged(const LogDataPointRef& event) override;
 };
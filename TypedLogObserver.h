@@ -0,0 +1,50 @@
+/**
+* Typed Log Observer : Receives data points as typed values indexed by
+*	column id, instead of as a map of column names to text.
+*
+* - The logger publishes its schema (see LogSchema.h) once, when the header
+*		line is written. Observers look up the columns they care about by
+*		name or category there, and keep the ids.
+* - Every data point after that is a LogDataPointEvent: one typed value per
+*		column, in schema order, so Date is values[LOG_DATE_COLUMN_ID] and a
+*		FLOAT column is read with values[id].floatValue. Nothing is formatted
+*		or parsed on the way.
+* - All observers share the same read-only, pooled buffer for a data point
+*		(see LogDataPointPool.h). An observer that needs it after the call
+*		keeps a copy of the LogDataPointRef, not of the values.
+* - Add to a logger with LogNotifier::addTypedObserver(..). Observers added
+*		after the header line was written receive the current schema at once.
+*
+* Example usage:
+*
+*	void PowerObserver::onSchemaPublished(const std::shared_ptr<const LogSchema>& schema) {
+*		powerColumn = schema->FindColumn("PowerMonitor-Out");
+*	}
+*	void PowerObserver::onDataPointLogged(const LogDataPointRef& event) {
+*		if (powerColumn != LOG_COLUMN_NOT_FOUND)
+*			plot(event->values.GetAsFloat(powerColumn));
+*	}
+*
+*
+* @file TypedLogObserver.h
+* @created October 2026
+* @version 1.0
+*/
+#pragma once
+
+#include <memory>
+
+#include "LogDataPointPool.h"
+#include "LogSchema.h"
+
+
+class TypedLogObserver {
+
+public:
+	virtual ~TypedLogObserver() = default;
+
+	// Called before the first data point with a new schema.
+	virtual void onSchemaPublished(const std::shared_ptr<const LogSchema>& schema) = 0;
+	virtual void onDataPointLogged(const LogDataPointRef& event) = 0;
+
+};